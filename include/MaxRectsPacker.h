@@ -0,0 +1,67 @@
+#ifndef MAXRECTSPACKER_H
+#define MAXRECTSPACKER_H
+
+#include <vector>
+
+struct PackSettings {
+	int maxWidth = 2048;
+	int maxHeight = 2048;
+	bool powerOfTwo = false;
+	bool allowRotation = true;
+	int padding = 2;  // transparent pixels between rectangles
+};
+
+struct PackPlacement {
+	int page = -1;
+	int x = 0;
+	int y = 0;
+	bool rotated = false;  // placed as height x width
+};
+
+struct PackedPage {
+	int width = 0;
+	int height = 0;
+};
+
+// How MaxRectsBin picks among the free positions a rectangle fits in.
+enum class FitRule {
+	ShortSide,   // least leftover on the shorter side
+	Area,        // smallest free rectangle
+	BottomLeft   // lowest top edge, then leftmost
+};
+
+// Free-rectangle list of one bin, filled by the MaxRects algorithm.
+class MaxRectsBin {
+public:
+	MaxRectsBin(int width, int height, bool allowRotation, FitRule rule = FitRule::ShortSide);
+
+	// Places a width x height rectangle, rotated if that fits better; false if it does not fit at all.
+	bool insert(int width, int height, PackPlacement& placement);
+	// Right and bottom edges of everything placed so far.
+	int usedWidth() const { return usedWidth_; }
+	int usedHeight() const { return usedHeight_; }
+
+private:
+	struct Rect {
+		int x, y, width, height;
+	};
+
+	void splitFreeRects(const Rect& used);
+	void pruneFreeRects();
+
+	bool allowRotation_;
+	FitRule rule_;
+	std::vector<Rect> free_;
+	int usedWidth_ = 0;
+	int usedHeight_ = 0;
+};
+
+// Packs width x height rectangles into as few pages as it can, each no larger than the maximum size and
+// shrunk to the smallest power of two or to its used area. Every fit rule is tried with two orders
+// (longest side first, largest area first) and the layout with the fewest pages, then the least area,
+// wins. Fills `placements` (one per rectangle, empty rectangles go to page 0 at 0, 0) and returns the
+// pages; returns no pages if some rectangle cannot fit on a page.
+std::vector<PackedPage> packRects(const std::vector<std::pair<int, int>>& sizes, const PackSettings& settings,
+								  std::vector<PackPlacement>& placements);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// zlib stream fed incrementally. It uses fixed Huffman codes and the same hashed match search as
+// stb_image_write (quality = stbi_write_png_compression_level), but keeps only the 32K window and the
+// lookahead in memory, so its input never has to exist in one piece.
+class ZlibStream {
+public:
+	// Without the zlib header the stream is raw deflate, for chunks compressed separately and
+	// appended to another stream with appendFlushed.
+	explicit ZlibStream(int quality = 8, bool zlibHeader = true);
+
+	// Makes the last 32K of `data` history that the first matches may refer to, as if it had been
+	// written just before; only on a new stream, for chunks continuing another stream's data.
+	void setDictionary(const unsigned char* data, size_t size);
+
+	void write(const unsigned char* data, size_t size);
+	// Sync flush: encodes all input and ends on a byte boundary with an empty stored block, after
+	// which independently compressed blocks may follow.
+	void flush();
+	// Appends raw deflate blocks ending in a sync flush, compressed from `data` without this stream's
+	// window. The stream must have just been flushed.
+	void appendFlushed(const std::vector<unsigned char>& blocks, const unsigned char* data, size_t size);
+	// Encodes the remaining input and appends the final block and checksum.
+	void finish();
+
+	// Compressed bytes produced so far; callers may move them out and clear the buffer at any time.
+	std::vector<unsigned char>& output() { return output_; }
+
+private:
+	void addInput(const unsigned char* data, size_t size);
+	void encode(bool flushAll);
+	size_t findMatch(size_t position, size_t& distance) const;
+	void insert(size_t position);
+	void openBlock();
+	void addBits(uint32_t code, int count);
+	void addHuffman(int symbol);
+	void addLength(size_t length, size_t distance);
+
+	int quality_;
+	bool blockOpen_ = false;
+	std::vector<unsigned char> window_;  // input from absolute position base_ on
+	size_t base_ = 0;
+	size_t position_ = 0;                // next input byte to encode
+	std::vector<size_t> head_;
+	std::vector<size_t> previous_;
+	uint32_t bitBuffer_ = 0;
+	int bitCount_ = 0;
+	uint32_t adlerA_ = 1, adlerB_ = 0;
+	std::vector<unsigned char> output_;
+};
+
+enum class PngLevel {
+	Fast,     // short match search, Paeth filter on every row
+	Default,  // stb_image_write's settings
+	Max       // long match search
+};
+
+// 8-bit PNG written row by row: rows are filtered like stb_image_write does (best of the five filters
+// per row) and compressed as they arrive, and IDAT chunks are flushed to the file as they fill up.
+// Rows are compressed in chunks of a fixed number of rows for the image width, joined at sync-flush
+// boundaries; each chunk starts from the 32K of data before it, so it loses little against one stream.
+// With more than one thread, chunks are filtered and compressed concurrently; the file is the same
+// whatever the number of threads.
+class PngStreamWriter {
+public:
+	PngStreamWriter(const std::string& path, int width, int height, int channels,
+					PngLevel level = PngLevel::Default, unsigned int threads = 1);
+
+	bool ok() const { return static_cast<bool>(file_); }
+	// Rows are passed top to bottom; `stride` is the distance between rows in bytes.
+	void writeRows(const unsigned char* rows, int rowCount, size_t stride);
+	// Returns false unless exactly `height` rows were written and the file could be completed.
+	bool finish();
+
+private:
+	void filterRows(const unsigned char* rows, size_t rowCount, const unsigned char* prior, unsigned char* out) const;
+	void compressBatch(bool all);
+	void writeChunk(const char* type, const unsigned char* data, size_t size);
+	void flushData(bool all);
+
+	std::ofstream file_;
+	int width_, height_, channels_;
+	size_t rowSize_;
+	int quality_;
+	int forcedFilter_;
+	unsigned int threads_;
+	int rowsWritten_ = 0;
+	std::vector<unsigned char> previousRow_;
+	std::vector<unsigned char> batch_;       // raw rows waiting for a batch of chunks
+	std::vector<unsigned char> dictionary_;  // last 32K of filtered data compressed
+	size_t chunkRows_ = 0;
+	ZlibStream zlib_;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef SKELETONDATA_H
 #define SKELETONDATA_H
 
+#include <functional>
 #include <iostream>
 #include <map>
 #include <optional>
@@ -539,6 +540,192 @@ struct SkeletonData {
     std::vector<Animation> animations; 
 }; 
 
+/* diff */
+
+enum class DiffType {
+    Diff_Value,
+    Diff_Number,
+    Diff_Length,
+    Diff_MissingInFirst,
+    Diff_MissingInSecond
+};
+
+struct DiffTolerance {
+    float value = 0.05f;    // relative, same rule as tools/json_diff.py
+    float time = 0.01f;     // absolute, seconds
+    float angle = 0.05f;    // absolute, degrees
+    int color = 1;          // absolute, per 8-bit channel
+    float curve = 0.05f;    // relative, bezier control points
+};
+
+struct SkeletonDiff {
+    std::string path; 
+    DiffType type = DiffType::Diff_Value; 
+    std::string value1, value2; 
+    double difference = 0.0, relativeDifference = 0.0, tolerance = 0.0; 
+};
+
+/* curve timelines */
+
+enum class CurveChannel {
+    R1, G1, B1, A1, R2, G2, B2, V1, V2, V3, V4, V5, V6
+};
+
+enum class ChannelUnit {
+    Color,      // 0..1 per color channel
+    Rotation,   // degrees, bone rotate (shortest path in 3.x)
+    Angle,      // degrees, other angles
+    Length,     // skeleton units
+    Ratio,      // scales, mixes and percentages
+    Scalar      // other physics values
+};
+
+// The position of a channel in a timeline's channel list is its bezier index in 4.x curves.
+struct CurveChannelSpec {
+    CurveChannel channel;
+    ChannelUnit unit;
+};
+
+struct BezierPoint {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+/* deform */
+
+struct DeformOptimizeStats {
+    size_t trimmedValues = 0;  // zero offsets dropped from the ends of frames
+    size_t removedFrames = 0;  // frames repeating both neighbours
+};
+
+/* skinning */
+
+struct InfluenceLimitStats {
+    size_t vertices = 0;           // vertices that lost influences
+    size_t removedInfluences = 0;
+    float maxError = 0.0f;         // skeleton units, setup pose with and without each deform frame
+};
+
+/* subset */
+
+struct SubsetStats {
+    std::vector<std::string> unknownNames;  // requested animations or skins missing from the skeleton
+    size_t removedAnimations = 0, removedSkins = 0, removedBones = 0, removedSlots = 0, removedConstraints = 0, removedEvents = 0;
+};
+
+/* meshes */
+
+struct MeshOptimizeStats {
+    size_t meshes = 0;
+    size_t triangles = 0;
+    size_t missesBefore = 0, missesAfter = 0;  // simulated post-transform cache misses
+};
+
+/* region meshes */
+
+// The stored pixels of an atlas region, placed in its original (untrimmed) image.
+struct RegionAlpha {
+    int originalWidth = 0, originalHeight = 0;
+    int left = 0, top = 0, width = 0, height = 0;  // stored rectangle, from the original's top left
+    std::vector<unsigned char> alpha;              // width x height, rows top to bottom
+};
+
+struct TightMeshSettings {
+    int maxVertices = 8;           // hull vertices per mesh, at least 3
+    unsigned char threshold = 0;   // pixels with a higher alpha stay inside the hull
+    float minSaving = 0.1f;        // regions whose hull saves less of their drawn area stay quads
+};
+
+struct TightMeshStats {
+    size_t converted = 0;
+    size_t unchanged = 0;                       // saving too little, or no usable hull
+    size_t missing = 0;                         // region not in the atlas
+    double areaBefore = 0.0, areaAfter = 0.0;   // drawn area of the converted attachments, atlas pixels
+};
+
+/* lazy reading */
+
+struct AnimationRange {
+    std::string name;
+    size_t offset = 0, size = 0;       // bytes in the binary, name included
+    std::vector<std::string> events;   // events it fires, filled by the lazy readers
+};
+
+// A binary skeleton read without its animations, which are decoded from the kept binary on request.
+// Decoding looks bones, slots, skins and strings up by index in `skeleton`, so load before editing it.
+struct LazySkeletonData {
+    SkeletonData skeleton;
+    std::vector<AnimationRange> animationRanges;
+    Binary binary;
+    Animation (*readAnimation)(DataInput*, SkeletonData*) = nullptr;
+};
+
+/* shards */
+
+struct AnimationGroup {
+    std::string name;                     // shard file suffix
+    std::vector<std::string> animations;
+};
+
+// A skeleton without animations plus one shard per animation group, each tagged with the skeleton hash.
+struct BinarySplit {
+    Binary base;
+    std::vector<std::pair<std::string, Binary>> shards;
+};
+
+struct JsonSplit {
+    Json base;
+    std::vector<std::pair<std::string, Json>> shards;
+};
+
+/* skeleton files */
+
+enum class SpineVersion {
+    Version35 = 0,
+    Version36 = 1,
+    Version37 = 2,
+    Version38 = 3,
+    Version40 = 4,
+    Version41 = 5,
+    Version42 = 6,
+    Invalid = -1
+};
+
+enum class FileFormat {
+    Json,
+    Skel,
+    Unknown
+};
+
+/* conversion */
+
+// What convertSkeleton does besides changing the format and version, in the order it does it.
+struct ConversionSettings {
+    FileFormat inputFormat = FileFormat::Unknown;     // Unknown: from the content
+    FileFormat outputFormat = FileFormat::Unknown;    // Unknown: the input format
+    SpineVersion outputVersion = SpineVersion::Invalid;  // Invalid: the input version
+    std::string outputVersionString; // 完整的版本号字符串，如 "4.2.11"
+    bool removeCurve = false;
+    std::optional<float> scale;
+    std::optional<float> bakeCurvesFps;
+    std::optional<float> reduceKeysTolerance;
+    bool optimizeDeform = false;
+    std::optional<int> maxInfluences;
+    bool optimizeTriangles = false;
+    bool reorderVertices = false;
+    std::vector<std::string> animations;
+    std::vector<std::string> skins;
+    bool writeIndex = false;
+    bool split = false;
+    std::vector<AnimationGroup> groups;
+};
+
+struct ConversionResult {
+    Binary output;                                       // the skeleton; without animations when split
+    std::vector<std::pair<std::string, Binary>> shards;  // when split: animation group and shard content
+    std::string index;                                   // with writeIndex and .skel output: the index JSON
+};
+
 /* common functions */
 
 Color stringToColor(const std::string& str, bool hasAlpha); 
@@ -553,6 +740,13 @@ int readVarint(DataInput*, bool optimizePositive);
 float readFloat(DataInput*); 
 OptStr readString(DataInput*); 
 OptStr readStringRef(DataInput*, SkeletonData*); 
+void skipBytes(DataInput*, size_t count); 
+void skipString(DataInput*); 
+// Fixed-size frames, each but the last followed by a curve type (and four floats for a bezier) in 3.x.
+// 4.x stores the bezier count first and each curve after the next frame, four floats per channel.
+// The bezier count is only an allocation hint, some writers round it up, so curves are still scanned.
+void skipCurveTimeline3x(DataInput*, int frameCount, size_t frameSize); 
+void skipCurveTimeline4x(DataInput*, int frameCount, size_t frameSize, int channels); 
 
 void writeByte(Binary&, unsigned char); 
 void writeSByte(Binary&, signed char);
@@ -570,45 +764,52 @@ uint64_t base64ToUint64(const std::string&);
 
 namespace spine35 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
 
 namespace spine36 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
 
 namespace spine37 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
 namespace spine38 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
 namespace spine40 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
 namespace spine41 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
 namespace spine42 {
     SkeletonData readBinaryData(const Binary&);
-    Binary writeBinaryData(SkeletonData&);
+    LazySkeletonData readBinaryDataLazy(Binary);
+    Binary writeBinaryData(SkeletonData&, std::vector<AnimationRange>* animationRanges = nullptr);
     SkeletonData readJsonData(const Json&);
     Json writeJsonData(const SkeletonData&);
 }
@@ -617,8 +818,100 @@ void convertCurve3xTo4x(SkeletonData& skeleton);
 void convertCurve4xTo3x(SkeletonData& skeleton);
 void removeCurve(SkeletonData& skeleton);
 void convertOrder42ToBelow(SkeletonData& skeleton);
+// Renumbers constraint orders (physics included) to 0..n-1, keeping their relative order.
+void compactConstraintOrders(SkeletonData& skeleton);
+// True when the constraint orders are exactly 0..n-1, the only orders runtimes add to their update cache.
+bool constraintOrdersDense(const SkeletonData& skeleton, bool includePhysics);
 void convertSpacingMode4xTo3x(SkeletonData& skeleton);
 void convertRotateTimeline3xTo4x(SkeletonData& skeleton);
 void convertRotateTimeline4xTo3x(SkeletonData& skeleton);
+size_t reduceKeyframes(SkeletonData& skeleton, float tolerance);
+size_t bakeCurves(SkeletonData& skeleton, float fps);
+DeformOptimizeStats optimizeDeformTimelines(SkeletonData& skeleton);
+InfluenceLimitStats limitBoneInfluences(SkeletonData& skeleton, int maxInfluences);
+// Keeps only the named animations and skins (all when a list is empty, the default skin always), then
+// removes bones, slots, constraints, events and timelines nothing remaining refers to.
+SubsetStats subsetSkeleton(SkeletonData& skeleton, const std::vector<std::string>& animations, const std::vector<std::string>& skins);
+// Reorders mesh triangles for vertex cache locality, optionally renumbering vertices by first use.
+MeshOptimizeStats optimizeMeshes(SkeletonData& skeleton, bool reorderVertices);
+// Decodes an animation into skeleton.animations unless already there; nullptr if the binary has none by
+// that name. The pointer is valid until the next load.
+const Animation* loadAnimation(LazySkeletonData& lazy, const std::string& name);
+// Decodes the named animations, or all when the list is empty, in binary order. Returns how many were decoded.
+size_t loadAnimations(LazySkeletonData& lazy, const std::vector<std::string>& names);
+// Sidecar index of a written binary: per animation its byte range (as recorded by writeBinaryData),
+// duration, timeline counts and the bones and slots it keys.
+Json buildAnimationIndex(const SkeletonData& skeleton, const std::vector<AnimationRange>& animationRanges);
+// Multiplies everything in skeleton units by `scale`, as a runtime loader's scale would at load time.
+void scaleSkeleton(SkeletonData& skeleton, float scale);
+// Atlas regions used by the region, mesh and linked mesh attachments of every skin, with each
+// sequence expanded to its frames' region names. Sorted.
+std::vector<std::string> referencedRegions(const SkeletonData& skeleton);
+// A sequence frame's region name, built like the runtimes' Sequence::getPath: the path, then
+// start + index padded with zeros to `digits`.
+std::string sequenceRegionName(const std::string& path, const Sequence& sequence, int index);
+// Replaces region attachments with meshes over the convex hull of their regions' visible pixels,
+// reduced to at most maxVertices by growing it, never past the stored rectangle. A sequence uses the
+// union of its frames when they share one rectangle.
+TightMeshStats tightenRegionAttachments(SkeletonData& skeleton, const std::map<std::string, RegionAlpha>& regions,
+                                        const TightMeshSettings& settings);
+// The hash as the skeleton's files store it: the 3.x string, or the base64 of the 64-bit hash.
+std::string skeletonHashString(const SkeletonData& skeleton);
+uint64_t hashBytes(const void* data, size_t size);
+// The given groups, then a group of its own for every animation in none of them.
+std::vector<AnimationGroup> groupAnimations(const SkeletonData& skeleton, const std::vector<AnimationGroup>& groups);
+// Splits a written binary at the animation ranges recorded by writeBinaryData; shards keep the bytes as written.
+BinarySplit splitBinary(const Binary& binary, const std::vector<AnimationRange>& animationRanges, const std::string& hash, const std::vector<AnimationGroup>& groups);
+// Appends the shards' animations, in their original order, to a base written by splitBinary. Throws if a shard's hash differs.
+Binary mergeBinary(const Binary& base, const std::string& hash, const std::vector<Binary>& shards);
+JsonSplit splitJson(const Json& json, const std::vector<AnimationGroup>& groups);
+Json mergeJson(const Json& base, const std::vector<Json>& shards);
+
+float normalizeRotationDelta(float delta);
+bool uses4xCurves(const SkeletonData& skeleton);
+float getCurveChannel(const TimelineFrame& frame, CurveChannel channel);
+void setCurveChannel(TimelineFrame& frame, CurveChannel channel, float value);
+// Visits bone, slot color, constraint and physics timelines with their channels. Timelines whose keys only
+// hold state (bone inherit) get an empty channel list; event-like timelines and deform are not visited.
+void forEachCurveTimeline(SkeletonData& skeleton, const std::function<void(Timeline&, const std::vector<CurveChannelSpec>&)>& visit);
+void forEachDeformTimeline(SkeletonData& skeleton, const std::function<void(Timeline&)>& visit);
+// Deform timelines grouped by the attachment owning the vertices they animate; timelines keyed on a
+// linked mesh belong to its parent mesh.
+std::map<const Attachment*, std::vector<Timeline*>> collectDeformTimelines(SkeletonData& skeleton);
+
+BezierPoint evaluateBezier(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float t);
+void evaluateBezierBatch(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3,
+                         const float* t, float* x, float* y, size_t count);
+float findBezierTForX(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float x);
+// Smallest t in [0, 1] where the curve reaches y; false if it never does.
+bool findBezierTForY(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float y, float& t);
+
+std::vector<SkeletonDiff> diffSkeletonData(const SkeletonData& a, const SkeletonData& b, const DiffTolerance& tolerance);
+
+// Version from the x.y.z string near the start of the file; Invalid if there is none.
+SpineVersion detectSpineVersion(const std::string& filePath);
+SpineVersion detectSpineVersion(const unsigned char* data, size_t size);
+FileFormat detectFileFormat(const std::string& filePath);
+// From the content: JSON when it opens with an object, binary otherwise; Unknown when empty.
+FileFormat detectFileFormat(const unsigned char* data, size_t size);
+LazySkeletonData readBinaryDataLazy(Binary binaryData, SpineVersion inputVersion);
+// Reads a skeleton with the reader of its version. With `animations`, a binary only decodes those.
+SkeletonData readSkeletonData(const std::string& inputFile, FileFormat inputFormat, SpineVersion inputVersion,
+                              const std::vector<std::string>& animations = {});
+// The same from the file's content, with progress going to `log`.
+SkeletonData readSkeletonData(Binary content, FileFormat inputFormat, SpineVersion inputVersion,
+                              const std::vector<std::string>& animations, std::ostream& log);
+SkeletonData readSkeletonFile(const std::string& filePath);
+// Writes with the writer of `outputVersion`, the format following the file extension. Throws on failure.
+Binary writeBinaryData(SkeletonData& skeleton, SpineVersion outputVersion, std::vector<AnimationRange>* animationRanges = nullptr);
+Json writeJsonData(const SkeletonData& skeleton, SpineVersion outputVersion);
+void writeSkeletonFile(SkeletonData& skeleton, const std::string& filePath, SpineVersion outputVersion);
+// "x.y", or "Unknown".
+std::string getVersionString(SpineVersion version);
+// Version of a complete x.y.z string; Invalid for anything else.
+SpineVersion parseVersionString(const std::string& versionStr);
+// Converts a .json or .skel skeleton held in memory, as the converter does a file. Progress goes to
+// `log` and warnings to `warnings`; throws on failure.
+ConversionResult convertSkeleton(Binary input, const ConversionSettings& settings, std::ostream& log, std::ostream& warnings);
 
 #endif // SKELETONDATA_H
@@ -0,0 +1,88 @@
+#ifndef SPINECONV_H
+#define SPINECONV_H
+
+/* C interface of the converter, for tools calling it in-process (through FFI from C#, Python, ...)
+ * instead of running SpineSkeletonDataConverter once per file. Conversions are independent and may
+ * run on several threads at once. */
+
+#include <stddef.h>
+
+#if defined(SPINECONV_SHARED_BUILD)
+#  if defined(_WIN32)
+#    define SPINECONV_API __declspec(dllexport)
+#  else
+#    define SPINECONV_API __attribute__((visibility("default")))
+#  endif
+#elif defined(SPINECONV_SHARED) && defined(_WIN32)
+#  define SPINECONV_API __declspec(dllimport)
+#else
+#  define SPINECONV_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a function or the options struct changes incompatibly. */
+#define SPINECONV_ABI_VERSION 1
+
+enum {
+    SPINECONV_FORMAT_AUTO = 0, /* input: from the content; output: the input format */
+    SPINECONV_FORMAT_JSON = 1,
+    SPINECONV_FORMAT_SKEL = 2
+};
+
+/* Same meaning as the converter's command line options. Fill with spineconv_options_init first:
+ * `size` lets later versions add fields at the end without breaking callers built against this one. */
+typedef struct spineconv_options {
+    size_t size;
+    int input_format;
+    int output_format;
+    const char* output_version;      /* complete x.y.z version, or NULL for the input's (-v) */
+    int remove_curve;                /* --remove-curve */
+    float scale;                     /* --scale; 0 to leave the skeleton unscaled */
+    float bake_curves_fps;           /* --bake-curves; 0 to keep curves */
+    float reduce_keys_tolerance;     /* --reduce-keys; negative to keep every key */
+    int max_influences;              /* --max-influences; 0 to keep every influence */
+    int optimize_deform;             /* --optimize-deform */
+    int optimize_triangles;          /* --optimize-triangles */
+    int reorder_vertices;            /* --reorder-vertices */
+    const char* const* animations;   /* --animations; none keeps all */
+    size_t animation_count;
+    const char* const* skins;        /* --skins; none keeps all */
+    size_t skin_count;
+    int write_index;                 /* --index: see spineconv_result_index */
+    int split;                       /* --split: see spineconv_result_shard */
+    const char* const* groups;       /* --group, each "name=a,b,..." */
+    size_t group_count;
+} spineconv_options;
+
+/* Output and diagnostics of one conversion, owned by the library until spineconv_result_free. */
+typedef struct spineconv_result spineconv_result;
+
+SPINECONV_API int spineconv_abi_version(void);
+SPINECONV_API void spineconv_options_init(spineconv_options* options);
+
+/* Converts a .json or .skel skeleton held in `data`. Returns NULL only when out of memory; check
+ * spineconv_result_ok. `options` may be NULL for a plain conversion to the input's format and version. */
+SPINECONV_API spineconv_result* spineconv_convert(const void* data, size_t size, const spineconv_options* options);
+SPINECONV_API void spineconv_result_free(spineconv_result* result);
+
+SPINECONV_API int spineconv_result_ok(const spineconv_result* result);
+/* Progress, warnings and, on failure, the error, one per line, as the command line tool prints them.
+ * Never NULL. */
+SPINECONV_API const char* spineconv_result_diagnostics(const spineconv_result* result);
+/* The converted skeleton; without animations when split. */
+SPINECONV_API const unsigned char* spineconv_result_data(const spineconv_result* result, size_t* size);
+/* When split: one shard per animation group, which the command line tool writes to <stem>.<name><ext>. */
+SPINECONV_API size_t spineconv_result_shard_count(const spineconv_result* result);
+SPINECONV_API const char* spineconv_result_shard_name(const spineconv_result* result, size_t index);
+SPINECONV_API const unsigned char* spineconv_result_shard_data(const spineconv_result* result, size_t index, size_t* size);
+/* With write_index and .skel output, the animation index JSON; NULL otherwise. */
+SPINECONV_API const char* spineconv_result_index(const spineconv_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
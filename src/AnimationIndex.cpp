@@ -0,0 +1,100 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <set>
+
+namespace {
+
+float lastKeyTime(const Timeline& timeline) {
+    return timeline.empty() ? 0.0f : timeline.back().time;
+}
+
+// Names in skeleton order, so the index is stable whatever order the timelines are stored in.
+template <typename Items>
+Json orderedNames(const Items& items, const std::set<std::string>& names) {
+    Json result = Json::array();
+    for (const auto& item : items)
+        if (item.name && names.count(*item.name)) result.push_back(*item.name);
+    return result;
+}
+
+Json indexAnimation(const SkeletonData& skeleton, const Animation& animation, const AnimationRange& range) {
+    float duration = 0.0f;
+    std::set<std::string> bones, slots;
+    size_t boneTimelines = 0, slotTimelines = 0, ikTimelines = 0, transformTimelines = 0, pathTimelines = 0, physicsTimelines = 0, attachmentTimelines = 0;
+
+    auto visitMulti = [&](const std::map<std::string, MultiTimeline>& targets, size_t& count) {
+        for (const auto& [name, multi] : targets) {
+            for (const auto& [type, timeline] : multi) {
+                duration = std::max(duration, lastKeyTime(timeline));
+                count++;
+            }
+        }
+    };
+    visitMulti(animation.bones, boneTimelines);
+    visitMulti(animation.slots, slotTimelines);
+    visitMulti(animation.path, pathTimelines);
+    visitMulti(animation.physics, physicsTimelines);
+    auto visitSingle = [&](const std::map<std::string, Timeline>& targets, size_t& count) {
+        for (const auto& [name, timeline] : targets) {
+            duration = std::max(duration, lastKeyTime(timeline));
+            count++;
+        }
+    };
+    visitSingle(animation.ik, ikTimelines);
+    visitSingle(animation.transform, transformTimelines);
+    for (const auto& [skinName, skinSlots] : animation.attachments) {
+        for (const auto& [slotName, attachments] : skinSlots) {
+            slots.insert(slotName);
+            for (const auto& [attachmentName, multi] : attachments) {
+                for (const auto& [type, timeline] : multi) {
+                    duration = std::max(duration, lastKeyTime(timeline));
+                    attachmentTimelines++;
+                }
+            }
+        }
+    }
+    for (const auto& frame : animation.drawOrder)
+        for (const auto& [slotName, offset] : frame.offsets) slots.insert(slotName);
+    duration = std::max({duration, lastKeyTime(animation.drawOrder), lastKeyTime(animation.events)});
+    for (const auto& [name, multi] : animation.bones) bones.insert(name);
+    for (const auto& [name, multi] : animation.slots) slots.insert(name);
+
+    Json entry;
+    entry["name"] = range.name;
+    entry["offset"] = range.offset;
+    entry["size"] = range.size;
+    entry["duration"] = duration;
+    entry["timelines"] = {
+        {"bone", boneTimelines},
+        {"slot", slotTimelines},
+        {"ik", ikTimelines},
+        {"transform", transformTimelines},
+        {"path", pathTimelines},
+        {"physics", physicsTimelines},
+        {"attachment", attachmentTimelines},
+        {"drawOrder", animation.drawOrder.empty() ? 0 : 1},
+        {"event", animation.events.empty() ? 0 : 1}
+    };
+    entry["bones"] = orderedNames(skeleton.bones, bones);
+    entry["slots"] = orderedNames(skeleton.slots, slots);
+    return entry;
+}
+
+}
+
+Json buildAnimationIndex(const SkeletonData& skeleton, const std::vector<AnimationRange>& animationRanges) {
+    Json index;
+    index["hash"] = skeletonHashString(skeleton);
+    if (skeleton.version) index["version"] = *skeleton.version;
+    // Bytes before the first animation: everything a loader reads eagerly, the animation count included.
+    if (!animationRanges.empty()) index["header"] = animationRanges.front().offset;
+    Json animations = Json::array();
+    for (const auto& range : animationRanges) {
+        auto it = std::find_if(skeleton.animations.begin(), skeleton.animations.end(), [&](const Animation& animation) {
+            return animation.name == range.name;
+        });
+        if (it != skeleton.animations.end()) animations.push_back(indexAnimation(skeleton, *it, range));
+    }
+    index["animations"] = animations;
+    return index;
+}
@@ -0,0 +1,151 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double rootEpsilon = 1e-7;
+
+BezierPoint lerp(const BezierPoint& a, const BezierPoint& b, float t) {
+    return {
+        a.x + (b.x - a.x) * t,
+        a.y + (b.y - a.y) * t
+    };
+}
+
+// Power basis of one bezier axis: a t^3 + b t^2 + c t + d.
+struct Cubic {
+    double a, b, c, d;
+    double operator()(double t) const { return ((a * t + b) * t + c) * t + d; }
+    double derivative(double t) const { return (3.0 * a * t + 2.0 * b) * t + c; }
+};
+
+Cubic toPowerBasis(float p0, float p1, float p2, float p3) {
+    return {
+        -p0 + 3.0 * p1 - 3.0 * p2 + p3,
+        3.0 * p0 - 6.0 * p1 + 3.0 * p2,
+        -3.0 * p0 + 3.0 * p1,
+        p0
+    };
+}
+
+// Real roots of the cubic in closed form (Cardano / trigonometric), unsorted.
+int solveCubic(const Cubic& cubic, double roots[3]) {
+    double scale = std::max({ std::fabs(cubic.a), std::fabs(cubic.b), std::fabs(cubic.c), std::fabs(cubic.d) });
+    if (scale == 0.0) return 0;
+    double a = cubic.a / scale, b = cubic.b / scale, c = cubic.c / scale, d = cubic.d / scale;
+
+    if (std::fabs(a) < 1e-9) {
+        if (std::fabs(b) < 1e-9) {
+            if (std::fabs(c) < 1e-12) return 0;
+            roots[0] = -d / c;
+            return 1;
+        }
+        double discriminant = c * c - 4.0 * b * d;
+        if (discriminant < 0.0) return 0;
+        double sqrtDiscriminant = std::sqrt(discriminant);
+        // Numerically stable form, avoids cancellation between -c and the square root.
+        double q = -0.5 * (c + (c >= 0.0 ? sqrtDiscriminant : -sqrtDiscriminant));
+        int count = 0;
+        if (q != 0.0) roots[count++] = d / q;
+        roots[count++] = q / b;
+        return count;
+    }
+
+    double A = b / a, B = c / a, C = d / a;
+    double p = B - A * A / 3.0;
+    double q = 2.0 * A * A * A / 27.0 - A * B / 3.0 + C;
+    double shift = -A / 3.0;
+    double discriminant = q * q / 4.0 + p * p * p / 27.0;
+
+    if (discriminant > 1e-14) {
+        double sqrtDiscriminant = std::sqrt(discriminant);
+        roots[0] = std::cbrt(-q / 2.0 + sqrtDiscriminant) + std::cbrt(-q / 2.0 - sqrtDiscriminant) + shift;
+        return 1;
+    }
+    if (discriminant > -1e-14) {
+        double u = std::cbrt(-q / 2.0);
+        roots[0] = 2.0 * u + shift;
+        roots[1] = -u + shift;
+        return 2;
+    }
+    double r = std::sqrt(-p / 3.0);
+    double phi = std::acos(std::clamp(-q / (2.0 * r * r * r), -1.0, 1.0));
+    for (int k = 0; k < 3; ++k)
+        roots[k] = 2.0 * r * std::cos((phi + 2.0 * pi * k) / 3.0) + shift;
+    return 3;
+}
+
+// Smallest root of cubic(t) = value inside [0, 1], polished with Newton steps.
+bool findFirstRoot(const Cubic& cubic, double value, double& result) {
+    Cubic shifted = cubic;
+    shifted.d -= value;
+    double roots[3];
+    int count = solveCubic(shifted, roots);
+    bool found = false;
+    for (int i = 0; i < count; ++i) {
+        double t = roots[i];
+        for (int step = 0; step < 2; ++step) {
+            double slope = shifted.derivative(t);
+            if (std::fabs(slope) < 1e-12) break;
+            t -= shifted(t) / slope;
+        }
+        if (t < -rootEpsilon || t > 1.0 + rootEpsilon) continue;
+        t = std::clamp(t, 0.0, 1.0);
+        if (!found || t < result) result = t;
+        found = true;
+    }
+    return found;
+}
+
+}
+
+BezierPoint evaluateBezier(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float t) {
+    BezierPoint p01 = lerp(p0, p1, t);
+    BezierPoint p12 = lerp(p1, p2, t);
+    BezierPoint p23 = lerp(p2, p3, t);
+    BezierPoint p012 = lerp(p01, p12, t);
+    BezierPoint p123 = lerp(p12, p23, t);
+    return lerp(p012, p123, t);
+}
+
+void evaluateBezierBatch(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3,
+                         const float* t, float* x, float* y, size_t count) {
+    // Power basis with plain arrays so the loop has no dependencies between samples and vectorizes.
+    const float ax = -p0.x + 3.0f * p1.x - 3.0f * p2.x + p3.x, bx = 3.0f * p0.x - 6.0f * p1.x + 3.0f * p2.x, cx = 3.0f * (p1.x - p0.x);
+    const float ay = -p0.y + 3.0f * p1.y - 3.0f * p2.y + p3.y, by = 3.0f * p0.y - 6.0f * p1.y + 3.0f * p2.y, cy = 3.0f * (p1.y - p0.y);
+    for (size_t i = 0; i < count; ++i) {
+        float s = t[i];
+        x[i] = ((ax * s + bx) * s + cx) * s + p0.x;
+        y[i] = ((ay * s + by) * s + cy) * s + p0.y;
+    }
+}
+
+// The editor keeps control point times inside the segment, so x(t) is monotonic and has one root in [0, 1].
+float findBezierTForX(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float x) {
+    if (x <= p0.x) return 0.0f;
+    if (x >= p3.x) return 1.0f;
+    double t = 0.0;
+    if (findFirstRoot(toPowerBasis(p0.x, p1.x, p2.x, p3.x), x, t)) return static_cast<float>(t);
+
+    // Hand-edited data can break monotonicity; bisection still returns a point on the curve.
+    float low = 0.0f;
+    float high = 1.0f;
+    for (int step = 0; step < 24; ++step) {
+        float mid = (low + high) * 0.5f;
+        if (evaluateBezier(p0, p1, p2, p3, mid).x < x) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return (low + high) * 0.5f;
+}
+
+bool findBezierTForY(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float y, float& t) {
+    double result = 0.0;
+    if (!findFirstRoot(toPowerBasis(p0.y, p1.y, p2.y, p3.y), y, result)) return false;
+    t = static_cast<float>(result);
+    return true;
+}
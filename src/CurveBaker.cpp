@@ -0,0 +1,119 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+// Evaluates a curve at each time: one cubic root solve per sample, then one batched evaluation.
+std::vector<float> sampleBezier(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, const std::vector<float>& times) {
+    std::vector<float> t(times.size()), x(times.size()), y(times.size());
+    for (size_t i = 0; i < times.size(); ++i) t[i] = findBezierTForX(p0, p1, p2, p3, times[i]);
+    evaluateBezierBatch(p0, p1, p2, p3, t.data(), x.data(), y.data(), times.size());
+    return y;
+}
+
+// Progress of a 3.x curve or a 4.x deform curve at each time: 3.x curves are normalized in both
+// axes, 4.x deform curves are absolute in time and 0..1 in value.
+std::vector<float> sampleSharedCurve(const TimelineFrame& start, const TimelineFrame& end, const std::vector<float>& times, bool curves4x) {
+    const auto& c = start.curve;
+    if (curves4x) return sampleBezier({start.time, 0.0f}, {c[0], c[1]}, {c[2], c[3]}, {end.time, 1.0f}, times);
+    std::vector<float> normalized(times.size());
+    for (size_t i = 0; i < times.size(); ++i) normalized[i] = (times[i] - start.time) / (end.time - start.time);
+    return sampleBezier({0.0f, 0.0f}, {c[0], c[1]}, {c[2], c[3]}, {1.0f, 1.0f}, normalized);
+}
+
+std::vector<float> sampleChannel(const TimelineFrame& start, const TimelineFrame& end, const CurveChannelSpec& spec, size_t bezierIndex, const std::vector<float>& times, bool curves4x) {
+    float startValue = getCurveChannel(start, spec.channel);
+    float endValue = getCurveChannel(end, spec.channel);
+    if (curves4x) {
+        const float* c = start.curve.data() + bezierIndex * 4;
+        return sampleBezier({start.time, startValue}, {c[0], c[1]}, {c[2], c[3]}, {end.time, endValue}, times);
+    }
+    float delta = spec.unit == ChannelUnit::Rotation ? normalizeRotationDelta(endValue - startValue) : endValue - startValue;
+    std::vector<float> values = sampleSharedCurve(start, end, times, false);
+    for (float& value : values) value = startValue + delta * value;
+    return values;
+}
+
+std::vector<float> expandDeform(const TimelineFrame& frame, size_t offset, size_t count) {
+    std::vector<float> vertices(count, 0.0f);
+    for (size_t i = 0; i < frame.vertices.size(); ++i) {
+        size_t index = static_cast<size_t>(frame.int1) + i;
+        if (index >= offset && index < offset + count) vertices[index - offset] = frame.vertices[i];
+    }
+    return vertices;
+}
+
+// Uniform subdivision keeps every sample interval at or below 1 / fps and lands exactly on the end key.
+size_t sampleCount(const TimelineFrame& start, const TimelineFrame& end, float fps) {
+    float duration = end.time - start.time;
+    if (duration <= 0.0f) return 0;
+    return static_cast<size_t>(std::max(1.0f, std::ceil(duration * fps - 0.001f)));
+}
+
+template <typename SampleFunc>
+size_t bakeTimeline(Timeline& timeline, float fps, size_t curveFloats, SampleFunc sampleSegment) {
+    bool hasBezier = std::any_of(timeline.begin(), timeline.end(), [](const TimelineFrame& frame) {
+        return frame.curveType == CurveType::CURVE_BEZIER;
+    });
+    if (!hasBezier) return 0;
+
+    Timeline baked;
+    baked.reserve(timeline.size());
+    size_t inserted = 0;
+    for (size_t k = 0; k < timeline.size(); ++k) {
+        const TimelineFrame& start = timeline[k];
+        baked.push_back(start);
+        if (start.curveType != CurveType::CURVE_BEZIER) continue;
+        baked.back().curveType = CurveType::CURVE_LINEAR;
+        baked.back().curve.clear();
+        if (k + 1 == timeline.size() || start.curve.size() < curveFloats) continue;
+
+        const TimelineFrame& end = timeline[k + 1];
+        size_t steps = sampleCount(start, end, fps);
+        if (steps < 2) continue;
+        std::vector<float> times(steps - 1);
+        for (size_t j = 1; j < steps; ++j) times[j - 1] = start.time + (end.time - start.time) * j / steps;
+        Timeline samples(times.size(), baked.back());
+        for (size_t j = 0; j < times.size(); ++j) samples[j].time = times[j];
+        sampleSegment(start, end, times, samples);
+        inserted += samples.size();
+        std::move(samples.begin(), samples.end(), std::back_inserter(baked));
+    }
+    timeline = std::move(baked);
+    return inserted;
+}
+
+}
+
+size_t bakeCurves(SkeletonData& skeleton, float fps) {
+    bool curves4x = uses4xCurves(skeleton);
+    size_t inserted = 0;
+    forEachCurveTimeline(skeleton, [&](Timeline& timeline, const std::vector<CurveChannelSpec>& channels) {
+        if (channels.empty()) return;
+        size_t curveFloats = curves4x ? channels.size() * 4 : 4;
+        inserted += bakeTimeline(timeline, fps, curveFloats, [&](const TimelineFrame& start, const TimelineFrame& end, const std::vector<float>& times, Timeline& samples) {
+            for (size_t i = 0; i < channels.size(); ++i) {
+                std::vector<float> values = sampleChannel(start, end, channels[i], i, times, curves4x);
+                for (size_t j = 0; j < samples.size(); ++j) setCurveChannel(samples[j], channels[i].channel, values[j]);
+            }
+        });
+    });
+    forEachDeformTimeline(skeleton, [&](Timeline& timeline) {
+        inserted += bakeTimeline(timeline, fps, 4, [&](const TimelineFrame& start, const TimelineFrame& end, const std::vector<float>& times, Timeline& samples) {
+            if (start.vertices.empty() && end.vertices.empty()) return;
+            size_t offset = static_cast<size_t>(std::min(start.vertices.empty() ? end.int1 : start.int1, end.vertices.empty() ? start.int1 : end.int1));
+            size_t last = std::max(start.int1 + start.vertices.size(), end.int1 + end.vertices.size());
+            std::vector<float> from = expandDeform(start, offset, last - offset);
+            std::vector<float> to = expandDeform(end, offset, last - offset);
+            std::vector<float> progress = sampleSharedCurve(start, end, times, curves4x);
+            for (size_t j = 0; j < samples.size(); ++j) {
+                samples[j].int1 = static_cast<int>(offset);
+                samples[j].vertices.resize(from.size());
+                for (size_t i = 0; i < from.size(); ++i) samples[j].vertices[i] = from[i] + (to[i] - from[i]) * progress[j];
+            }
+        });
+    });
+    return inserted;
+}
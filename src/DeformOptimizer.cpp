@@ -0,0 +1,67 @@
+#include "SkeletonData.h"
+
+namespace {
+
+// Deform vertices are offsets from the setup pose and every runtime fills missing values with zero,
+// so zeros at either end of a frame can be dropped by moving the start offset.
+size_t trimFrame(TimelineFrame& frame) {
+    auto& vertices = frame.vertices;
+    size_t first = 0;
+    while (first < vertices.size() && vertices[first] == 0.0f) ++first;
+    size_t last = vertices.size();
+    while (last > first && vertices[last - 1] == 0.0f) --last;
+    size_t trimmed = vertices.size() - (last - first);
+    if (trimmed == 0) return 0;
+
+    if (first == last) {
+        vertices.clear();
+        frame.int1 = 0;
+    } else {
+        vertices.erase(vertices.begin() + last, vertices.end());
+        vertices.erase(vertices.begin(), vertices.begin() + first);
+        frame.int1 += static_cast<int>(first);
+    }
+    return trimmed;
+}
+
+// Only valid on trimmed frames, where equal deforms have equal storage.
+bool sameDeform(const TimelineFrame& a, const TimelineFrame& b) {
+    return a.vertices == b.vertices && (a.vertices.empty() || a.int1 == b.int1);
+}
+
+// A frame equal to both neighbours lies on a constant span whatever the curves are, so removing it
+// leaves the previous frame holding the same value up to the next one. First and last frames are kept
+// because they define the timeline's start and the animation duration.
+size_t collapseRepeatedFrames(Timeline& timeline) {
+    if (timeline.size() < 3) return 0;
+
+    Timeline collapsed;
+    collapsed.reserve(timeline.size());
+    collapsed.push_back(timeline.front());
+    for (size_t i = 1; i + 1 < timeline.size(); ++i) {
+        if (sameDeform(collapsed.back(), timeline[i]) && sameDeform(timeline[i], timeline[i + 1])) {
+            if (collapsed.back().curveType == CurveType::CURVE_BEZIER) {
+                collapsed.back().curveType = CurveType::CURVE_LINEAR;
+                collapsed.back().curve.clear();
+            }
+            continue;
+        }
+        collapsed.push_back(timeline[i]);
+    }
+    collapsed.push_back(timeline.back());
+
+    size_t removed = timeline.size() - collapsed.size();
+    timeline = std::move(collapsed);
+    return removed;
+}
+
+}
+
+DeformOptimizeStats optimizeDeformTimelines(SkeletonData& skeleton) {
+    DeformOptimizeStats stats;
+    forEachDeformTimeline(skeleton, [&](Timeline& timeline) {
+        for (auto& frame : timeline) stats.trimmedValues += trimFrame(frame);
+        stats.removedFrames += collapseRepeatedFrames(timeline);
+    });
+    return stats;
+}
@@ -0,0 +1,276 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+constexpr float degRad = 3.14159265358979323846f / 180.0f;
+
+struct BoneTransform {
+    float a = 1.0f, b = 0.0f, c = 0.0f, d = 1.0f, x = 0.0f, y = 0.0f;
+};
+
+struct Point {
+    float x = 0.0f, y = 0.0f;
+};
+
+struct Influence {
+    int bone = 0;
+    float x = 0.0f, y = 0.0f, weight = 0.0f;
+};
+
+typedef std::vector<std::vector<Influence>> WeightedVertices;
+
+// World transforms of the setup pose, following the runtimes' Bone::updateWorldTransform with the
+// skeleton at the origin and unscaled. Bones are stored parents first.
+std::vector<BoneTransform> computeSetupPose(const SkeletonData& skeleton) {
+    std::vector<BoneTransform> world(skeleton.bones.size());
+    std::map<std::string, size_t> indices;
+    for (size_t i = 0; i < skeleton.bones.size(); ++i) {
+        const BoneData& bone = skeleton.bones[i];
+        if (bone.name) indices[*bone.name] = i;
+        float rotationX = (bone.rotation + bone.shearX) * degRad;
+        float rotationY = (bone.rotation + 90.0f + bone.shearY) * degRad;
+        float la = std::cos(rotationX) * bone.scaleX, lb = std::cos(rotationY) * bone.scaleY;
+        float lc = std::sin(rotationX) * bone.scaleX, ld = std::sin(rotationY) * bone.scaleY;
+
+        BoneTransform& w = world[i];
+        auto parentIt = bone.parent ? indices.find(*bone.parent) : indices.end();
+        if (parentIt == indices.end()) {
+            w = { la, lb, lc, ld, bone.x, bone.y };
+            continue;
+        }
+        const BoneTransform& p = world[parentIt->second];
+        w.x = p.a * bone.x + p.b * bone.y + p.x;
+        w.y = p.c * bone.x + p.d * bone.y + p.y;
+        switch (bone.inherit) {
+            case Inherit_Normal:
+                w.a = p.a * la + p.b * lc; w.b = p.a * lb + p.b * ld;
+                w.c = p.c * la + p.d * lc; w.d = p.c * lb + p.d * ld;
+                break;
+            case Inherit_OnlyTranslation:
+                w.a = la; w.b = lb; w.c = lc; w.d = ld;
+                break;
+            case Inherit_NoRotationOrReflection: {
+                float pa = p.a, pb = p.b, pc = p.c, pd = p.d, prx = 0.0f;
+                float s = pa * pa + pc * pc;
+                if (s > 0.0001f) {
+                    s = std::fabs(pa * pd - pb * pc) / s;
+                    pb = pc * s;
+                    pd = pa * s;
+                    prx = std::atan2(pc, pa) / degRad;
+                } else {
+                    pa = 0.0f;
+                    pc = 0.0f;
+                    prx = 90.0f - std::atan2(pd, pb) / degRad;
+                }
+                float rx = (bone.rotation + bone.shearX - prx) * degRad;
+                float ry = (bone.rotation + bone.shearY - prx + 90.0f) * degRad;
+                la = std::cos(rx) * bone.scaleX; lb = std::cos(ry) * bone.scaleY;
+                lc = std::sin(rx) * bone.scaleX; ld = std::sin(ry) * bone.scaleY;
+                w.a = pa * la - pb * lc; w.b = pa * lb - pb * ld;
+                w.c = pc * la + pd * lc; w.d = pc * lb + pd * ld;
+                break;
+            }
+            case Inherit_NoScale:
+            case Inherit_NoScaleOrReflection: {
+                float cosine = std::cos(bone.rotation * degRad), sine = std::sin(bone.rotation * degRad);
+                float za = p.a * cosine + p.b * sine, zc = p.c * cosine + p.d * sine;
+                float s = std::sqrt(za * za + zc * zc);
+                if (s > 0.00001f) s = 1.0f / s;
+                za *= s;
+                zc *= s;
+                s = std::sqrt(za * za + zc * zc);
+                if (bone.inherit == Inherit_NoScale && p.a * p.d - p.b * p.c < 0.0f) s = -s;
+                float r = 90.0f * degRad + std::atan2(zc, za);
+                float zb = std::cos(r) * s, zd = std::sin(r) * s;
+                la = std::cos(bone.shearX * degRad) * bone.scaleX; lb = std::cos((90.0f + bone.shearY) * degRad) * bone.scaleY;
+                lc = std::sin(bone.shearX * degRad) * bone.scaleX; ld = std::sin((90.0f + bone.shearY) * degRad) * bone.scaleY;
+                w.a = za * la + zb * lc; w.b = za * lb + zb * ld;
+                w.c = zc * la + zd * lc; w.d = zc * lb + zd * ld;
+                break;
+            }
+        }
+    }
+    return world;
+}
+
+WeightedVertices parseWeighted(const std::vector<float>& vertices) {
+    WeightedVertices weighted;
+    size_t i = 0;
+    while (i < vertices.size()) {
+        size_t boneCount = static_cast<size_t>(vertices[i++]);
+        std::vector<Influence> influences;
+        for (size_t j = 0; j < boneCount && i + 3 < vertices.size(); ++j, i += 4)
+            influences.push_back({ static_cast<int>(vertices[i]), vertices[i + 1], vertices[i + 2], vertices[i + 3] });
+        weighted.push_back(std::move(influences));
+    }
+    return weighted;
+}
+
+std::vector<float> writeWeighted(const WeightedVertices& weighted) {
+    std::vector<float> vertices;
+    for (const auto& influences : weighted) {
+        vertices.push_back(static_cast<float>(influences.size()));
+        for (const auto& influence : influences) {
+            vertices.push_back(static_cast<float>(influence.bone));
+            vertices.push_back(influence.x);
+            vertices.push_back(influence.y);
+            vertices.push_back(influence.weight);
+        }
+    }
+    return vertices;
+}
+
+// Skinned world position, with deform offsets (two floats per influence, in influence order) if given.
+Point skinVertex(const std::vector<Influence>& influences, const std::vector<BoneTransform>& bones, const float* offsets) {
+    Point position;
+    for (size_t i = 0; i < influences.size(); ++i) {
+        const Influence& influence = influences[i];
+        if (influence.bone < 0 || static_cast<size_t>(influence.bone) >= bones.size()) continue;
+        const BoneTransform& bone = bones[influence.bone];
+        float x = influence.x + (offsets ? offsets[i * 2] : 0.0f);
+        float y = influence.y + (offsets ? offsets[i * 2 + 1] : 0.0f);
+        position.x += (bone.a * x + bone.b * y + bone.x) * influence.weight;
+        position.y += (bone.c * x + bone.d * y + bone.y) * influence.weight;
+    }
+    return position;
+}
+
+struct LimitedVertices {
+    WeightedVertices weighted;
+    std::vector<bool> kept; // per original influence, in storage order
+    size_t removed = 0;
+    size_t changedVertices = 0;
+};
+
+// Keeps the strongest influences of each vertex in their original order and renormalizes their weights.
+LimitedVertices limitInfluences(const WeightedVertices& weighted, size_t maxInfluences) {
+    LimitedVertices limited;
+    for (const auto& influences : weighted) {
+        if (influences.size() <= maxInfluences) {
+            limited.weighted.push_back(influences);
+            limited.kept.insert(limited.kept.end(), influences.size(), true);
+            continue;
+        }
+        std::vector<size_t> order(influences.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return influences[a].weight > influences[b].weight;
+        });
+        std::vector<bool> keep(influences.size(), false);
+        for (size_t i = 0; i < maxInfluences; ++i) keep[order[i]] = true;
+
+        std::vector<Influence> reduced;
+        float total = 0.0f;
+        for (size_t i = 0; i < influences.size(); ++i) {
+            if (!keep[i]) continue;
+            reduced.push_back(influences[i]);
+            total += influences[i].weight;
+        }
+        if (total > 0.0f)
+            for (auto& influence : reduced) influence.weight /= total;
+
+        limited.weighted.push_back(std::move(reduced));
+        limited.kept.insert(limited.kept.end(), keep.begin(), keep.end());
+        limited.removed += influences.size() - maxInfluences;
+        ++limited.changedVertices;
+    }
+    return limited;
+}
+
+float maxSkinningError(const WeightedVertices& before, const WeightedVertices& after, const std::vector<bool>& kept,
+                       const std::vector<BoneTransform>& bones, const std::vector<float>* offsets) {
+    float maxError = 0.0f;
+    std::vector<float> keptOffsets;
+    size_t influence = 0;
+    for (size_t v = 0; v < before.size(); ++v) {
+        const float* original = offsets ? offsets->data() + influence * 2 : nullptr;
+        const float* limited = nullptr;
+        if (offsets) {
+            keptOffsets.clear();
+            for (size_t i = 0; i < before[v].size(); ++i) {
+                if (!kept[influence + i]) continue;
+                keptOffsets.push_back(original[i * 2]);
+                keptOffsets.push_back(original[i * 2 + 1]);
+            }
+            limited = keptOffsets.data();
+        }
+        Point a = skinVertex(before[v], bones, original);
+        Point b = skinVertex(after[v], bones, limited);
+        maxError = std::max(maxError, std::hypot(a.x - b.x, a.y - b.y));
+        influence += before[v].size();
+    }
+    return maxError;
+}
+
+// Deform frames of weighted attachments hold one x, y offset per influence; offsets of removed
+// influences are dropped and the frame's start offset is moved past them.
+void remapDeformFrame(TimelineFrame& frame, const std::vector<bool>& kept) {
+    std::vector<float> vertices;
+    int start = 0;
+    for (int i = 0; i < frame.int1; ++i)
+        if (static_cast<size_t>(i / 2) < kept.size() && kept[i / 2]) ++start;
+    for (size_t i = 0; i < frame.vertices.size(); ++i) {
+        size_t index = static_cast<size_t>(frame.int1) + i;
+        if (index / 2 < kept.size() && kept[index / 2]) vertices.push_back(frame.vertices[i]);
+    }
+    frame.int1 = vertices.empty() ? 0 : start;
+    frame.vertices = std::move(vertices);
+}
+
+}
+
+InfluenceLimitStats limitBoneInfluences(SkeletonData& skeleton, int maxInfluences) {
+    InfluenceLimitStats stats;
+    if (maxInfluences < 1) return stats;
+    std::vector<BoneTransform> bones = computeSetupPose(skeleton);
+    auto deforms = collectDeformTimelines(skeleton);
+
+    for (auto& skin : skeleton.skins) {
+        for (auto& [slotName, slot] : skin.attachments) {
+            for (auto& [attachmentName, attachment] : slot) {
+                std::vector<float>* vertices = nullptr;
+                size_t vertexCount = 0;
+                if (auto* mesh = std::get_if<MeshAttachment>(&attachment.data)) {
+                    vertices = &mesh->vertices;
+                    vertexCount = mesh->uvs.size() / 2;
+                } else if (auto* box = std::get_if<BoundingboxAttachment>(&attachment.data)) {
+                    vertices = &box->vertices;
+                    vertexCount = box->vertexCount;
+                } else if (auto* path = std::get_if<PathAttachment>(&attachment.data)) {
+                    vertices = &path->vertices;
+                    vertexCount = path->vertexCount;
+                } else if (auto* clipping = std::get_if<ClippingAttachment>(&attachment.data)) {
+                    vertices = &clipping->vertices;
+                    vertexCount = clipping->vertexCount;
+                }
+                if (!vertices || vertices->size() == vertexCount * 2) continue;
+
+                WeightedVertices weighted = parseWeighted(*vertices);
+                LimitedVertices limited = limitInfluences(weighted, static_cast<size_t>(maxInfluences));
+                if (limited.removed == 0) continue;
+
+                stats.maxError = std::max(stats.maxError, maxSkinningError(weighted, limited.weighted, limited.kept, bones, nullptr));
+                auto deformIt = deforms.find(&attachment);
+                if (deformIt != deforms.end()) {
+                    std::vector<float> offsets;
+                    for (Timeline* timeline : deformIt->second) {
+                        for (auto& frame : *timeline) {
+                            offsets.assign(limited.kept.size() * 2, 0.0f);
+                            for (size_t i = 0; i < frame.vertices.size() && frame.int1 + i < offsets.size(); ++i)
+                                offsets[frame.int1 + i] = frame.vertices[i];
+                            stats.maxError = std::max(stats.maxError, maxSkinningError(weighted, limited.weighted, limited.kept, bones, &offsets));
+                            remapDeformFrame(frame, limited.kept);
+                        }
+                    }
+                }
+                *vertices = writeWeighted(limited.weighted);
+                stats.vertices += limited.changedVertices;
+                stats.removedInfluences += limited.removed;
+            }
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,165 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Channels are compared in authoring units: degrees and pixels as stored, ratios in percent,
+// colors in 8-bit steps. A single tolerance then means roughly the same visual error everywhere.
+constexpr float unitScale = 1.0f;
+constexpr float ratioScale = 100.0f;
+constexpr float colorScale = 255.0f;
+
+// Key values of one timeline, one row per key and one column per channel, already scaled.
+struct TimelineValues {
+    std::vector<std::vector<float>> keys;
+    std::vector<float> scales;
+    bool deform = false;
+    bool shortestRotation = false; // 3.x rotate keys interpolate along the shortest path
+};
+
+float unitToleranceScale(ChannelUnit unit) {
+    switch (unit) {
+        case ChannelUnit::Color: return colorScale;
+        case ChannelUnit::Ratio: return ratioScale;
+        default: return unitScale;
+    }
+}
+
+TimelineValues sampleChannels(const Timeline& timeline, const std::vector<CurveChannelSpec>& specs, bool curves4x) {
+    TimelineValues values;
+    values.shortestRotation = !curves4x && !specs.empty() && specs[0].unit == ChannelUnit::Rotation;
+    for (const auto& spec : specs) values.scales.push_back(unitToleranceScale(spec.unit));
+    for (const auto& frame : timeline) {
+        std::vector<float> key;
+        for (size_t i = 0; i < specs.size(); ++i) key.push_back(getCurveChannel(frame, specs[i].channel) * values.scales[i]);
+        values.keys.push_back(std::move(key));
+    }
+    if (values.shortestRotation) {
+        for (size_t i = 1; i < values.keys.size(); ++i)
+            values.keys[i][0] = values.keys[i - 1][0] + normalizeRotationDelta(values.keys[i][0] - values.keys[i - 1][0]);
+    }
+    return values;
+}
+
+TimelineValues sampleDeform(const Timeline& timeline) {
+    TimelineValues values;
+    values.deform = true;
+    size_t vertexCount = 0;
+    for (const auto& frame : timeline)
+        vertexCount = std::max(vertexCount, static_cast<size_t>(frame.int1) + frame.vertices.size());
+    values.scales.assign(vertexCount, unitScale);
+    for (const auto& frame : timeline) {
+        std::vector<float> key(vertexCount, 0.0f);
+        for (size_t i = 0; i < frame.vertices.size(); ++i) key[frame.int1 + i] = frame.vertices[i];
+        values.keys.push_back(std::move(key));
+    }
+    return values;
+}
+
+// Points whose convex hull contains the original curve of one channel between key k and k + 1.
+// For a bezier this is its control polygon, which bounds the curve for every curve format.
+std::vector<BezierPoint> segmentHull(const Timeline& timeline, const TimelineValues& values, size_t k, size_t channel, bool curves4x) {
+    const TimelineFrame& frame = timeline[k];
+    float x1 = frame.time, x2 = timeline[k + 1].time;
+    float y1 = values.keys[k][channel], y2 = values.keys[k + 1][channel];
+    switch (frame.curveType) {
+        case CurveType::CURVE_STEPPED:
+            return { {x1, y1}, {x2, y1} };
+        case CurveType::CURVE_BEZIER: {
+            size_t base = curves4x && !values.deform ? channel * 4 : 0;
+            if (frame.curve.size() < base + 4) break;
+            const float* c = frame.curve.data() + base;
+            if (curves4x && !values.deform) {
+                float scale = values.scales[channel];
+                return { {x1, y1}, {c[0], c[1] * scale}, {c[2], c[3] * scale}, {x2, y2} };
+            }
+            // 4.x deform curves are absolute in time and 0..1 in value, 3.x curves are 0..1 in both.
+            float cx1 = curves4x ? c[0] : x1 + c[0] * (x2 - x1);
+            float cx2 = curves4x ? c[2] : x1 + c[2] * (x2 - x1);
+            return { {x1, y1}, {cx1, y1 + c[1] * (y2 - y1)}, {cx2, y1 + c[3] * (y2 - y1)}, {x2, y2} };
+        }
+        case CurveType::CURVE_LINEAR:
+            break;
+    }
+    return { {x1, y1}, {x2, y2} };
+}
+
+bool sameDiscreteState(const TimelineFrame& a, const TimelineFrame& b) {
+    return a.inherit == b.inherit && a.bendPositive == b.bendPositive && a.compress == b.compress && a.stretch == b.stretch;
+}
+
+// Checks whether keys anchor + 1 .. last can be dropped so that a single segment from the anchor to
+// last + 1, of the given curve type, stays within tolerance of the original curve.
+bool canReplaceSegments(const Timeline& timeline, const TimelineValues& values, size_t anchor, size_t last, CurveType replacement, float tolerance, bool curves4x) {
+    size_t end = last + 1;
+    float startTime = timeline[anchor].time, endTime = timeline[end].time;
+    if (endTime <= startTime) return false;
+    if (replacement == CurveType::CURVE_LINEAR && values.shortestRotation &&
+        std::fabs(values.keys[end][0] - values.keys[anchor][0]) >= 180.0f) return false;
+
+    for (size_t channel = 0; channel < values.scales.size(); ++channel) {
+        float startValue = values.keys[anchor][channel], endValue = values.keys[end][channel];
+        for (size_t k = anchor; k <= last; ++k) {
+            auto hull = segmentHull(timeline, values, k, channel, curves4x);
+            // A stepped replacement jumps exactly at the end key, so the original end value is only
+            // relevant when the last original segment interpolates towards it.
+            if (replacement == CurveType::CURVE_STEPPED && k == last && timeline[k].curveType == CurveType::CURVE_STEPPED)
+                hull.pop_back();
+            for (const auto& point : hull) {
+                float expected = startValue;
+                if (replacement == CurveType::CURVE_LINEAR)
+                    expected += (endValue - startValue) * (point.x - startTime) / (endTime - startTime);
+                if (std::fabs(point.y - expected) > tolerance) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Greedily extends the segment starting at the last kept key over as many following keys as possible.
+// Errors are always measured against the original keys, so they do not accumulate. The first and last
+// keys are kept because they define the timeline's start and the animation duration.
+size_t reduceTimeline(Timeline& timeline, const TimelineValues& values, float tolerance, bool curves4x) {
+    if (timeline.size() < 3) return 0;
+
+    Timeline reduced;
+    reduced.reserve(timeline.size());
+    reduced.push_back(timeline.front());
+    size_t anchor = 0;
+    for (size_t i = 1; i + 1 < timeline.size(); ++i) {
+        if (sameDiscreteState(timeline[anchor], timeline[i])) {
+            if (timeline[anchor].curveType == CurveType::CURVE_STEPPED &&
+                canReplaceSegments(timeline, values, anchor, i, CurveType::CURVE_STEPPED, tolerance, curves4x)) {
+                reduced.back().curveType = CurveType::CURVE_STEPPED;
+                continue;
+            }
+            if (canReplaceSegments(timeline, values, anchor, i, CurveType::CURVE_LINEAR, tolerance, curves4x)) {
+                reduced.back().curveType = CurveType::CURVE_LINEAR;
+                reduced.back().curve.clear();
+                continue;
+            }
+        }
+        reduced.push_back(timeline[i]);
+        anchor = i;
+    }
+    reduced.push_back(timeline.back());
+
+    size_t removed = timeline.size() - reduced.size();
+    timeline = std::move(reduced);
+    return removed;
+}
+
+}
+
+size_t reduceKeyframes(SkeletonData& skeleton, float tolerance) {
+    bool curves4x = uses4xCurves(skeleton);
+    size_t removed = 0;
+    forEachCurveTimeline(skeleton, [&](Timeline& timeline, const std::vector<CurveChannelSpec>& channels) {
+        removed += reduceTimeline(timeline, sampleChannels(timeline, channels, curves4x), tolerance, curves4x);
+    });
+    forEachDeformTimeline(skeleton, [&](Timeline& timeline) {
+        removed += reduceTimeline(timeline, sampleDeform(timeline), tolerance, curves4x);
+    });
+    return removed;
+}
@@ -0,0 +1,41 @@
+#include "SkeletonData.h"
+#include <algorithm>
+
+namespace {
+
+Animation* findLoaded(SkeletonData& skeleton, const std::string& name) {
+    auto it = std::find_if(skeleton.animations.begin(), skeleton.animations.end(), [&](const Animation& animation) {
+        return animation.name == name;
+    });
+    return it == skeleton.animations.end() ? nullptr : &*it;
+}
+
+Animation decodeAnimation(LazySkeletonData& lazy, const AnimationRange& range) {
+    DataInput input;
+    input.cursor = lazy.binary.data() + range.offset;
+    input.end = input.cursor + range.size;
+    return lazy.readAnimation(&input, &lazy.skeleton);
+}
+
+}
+
+const Animation* loadAnimation(LazySkeletonData& lazy, const std::string& name) {
+    if (Animation* loaded = findLoaded(lazy.skeleton, name)) return loaded;
+    for (const auto& range : lazy.animationRanges) {
+        if (range.name != name) continue;
+        lazy.skeleton.animations.push_back(decodeAnimation(lazy, range));
+        return &lazy.skeleton.animations.back();
+    }
+    return nullptr;
+}
+
+size_t loadAnimations(LazySkeletonData& lazy, const std::vector<std::string>& names) {
+    size_t decoded = 0;
+    for (const auto& range : lazy.animationRanges) {
+        if (!names.empty() && std::find(names.begin(), names.end(), range.name) == names.end()) continue;
+        if (findLoaded(lazy.skeleton, range.name)) continue;
+        lazy.skeleton.animations.push_back(decodeAnimation(lazy, range));
+        decoded++;
+    }
+    return decoded;
+}
@@ -0,0 +1,282 @@
+#include "MaxRectsPacker.h"
+
+#include <algorithm>
+#include <climits>
+
+MaxRectsBin::MaxRectsBin(int width, int height, bool allowRotation, FitRule rule)
+	: allowRotation_(allowRotation), rule_(rule) {
+	free_.push_back({ 0, 0, width, height });
+}
+
+bool MaxRectsBin::insert(int width, int height, PackPlacement& placement) {
+	int bestPrimary = INT_MAX;
+	int bestSecondary = INT_MAX;
+	Rect best = { 0, 0, 0, 0 };
+	bool bestRotated = false;
+	auto consider = [&](const Rect& free, int w, int h, bool rotated) {
+		if (w > free.width || h > free.height) {
+			return;
+		}
+		int leftoverX = free.width - w;
+		int leftoverY = free.height - h;
+		int primary = std::min(leftoverX, leftoverY);
+		int secondary = std::max(leftoverX, leftoverY);
+		if (rule_ == FitRule::Area) {
+			secondary = primary;
+			primary = free.width * free.height - w * h;
+		} else if (rule_ == FitRule::BottomLeft) {
+			primary = free.y + h;
+			secondary = free.x;
+		}
+		if (primary < bestPrimary || (primary == bestPrimary && secondary < bestSecondary)) {
+			bestPrimary = primary;
+			bestSecondary = secondary;
+			best = { free.x, free.y, w, h };
+			bestRotated = rotated;
+		}
+	};
+	for (const Rect& free : free_) {
+		consider(free, width, height, false);
+		if (allowRotation_ && width != height) {
+			consider(free, height, width, true);
+		}
+	}
+	if (bestPrimary == INT_MAX) {
+		return false;
+	}
+
+	splitFreeRects(best);
+	pruneFreeRects();
+	usedWidth_ = std::max(usedWidth_, best.x + best.width);
+	usedHeight_ = std::max(usedHeight_, best.y + best.height);
+	placement.x = best.x;
+	placement.y = best.y;
+	placement.rotated = bestRotated;
+	return true;
+}
+
+// Every free rectangle overlapping the placed one is replaced by its parts left, right, above and below it.
+void MaxRectsBin::splitFreeRects(const Rect& used) {
+	std::vector<Rect> result;
+	result.reserve(free_.size() + 4);
+	for (const Rect& free : free_) {
+		if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+			used.y >= free.y + free.height || used.y + used.height <= free.y) {
+			result.push_back(free);
+			continue;
+		}
+		if (used.x > free.x) {
+			result.push_back({ free.x, free.y, used.x - free.x, free.height });
+		}
+		if (used.x + used.width < free.x + free.width) {
+			result.push_back({ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+		}
+		if (used.y > free.y) {
+			result.push_back({ free.x, free.y, free.width, used.y - free.y });
+		}
+		if (used.y + used.height < free.y + free.height) {
+			result.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+		}
+	}
+	free_.swap(result);
+}
+
+// Drops free rectangles contained in another one.
+void MaxRectsBin::pruneFreeRects() {
+	auto contains = [](const Rect& outer, const Rect& inner) {
+		return inner.x >= outer.x && inner.y >= outer.y &&
+			inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+	};
+	std::vector<char> removed(free_.size(), 0);
+	for (size_t i = 0; i < free_.size(); ++i) {
+		if (removed[i]) {
+			continue;
+		}
+		for (size_t j = 0; j < free_.size(); ++j) {
+			if (i == j || removed[j]) {
+				continue;
+			}
+			if (contains(free_[j], free_[i])) {
+				removed[i] = 1;
+				break;
+			}
+		}
+	}
+	size_t kept = 0;
+	for (size_t i = 0; i < free_.size(); ++i) {
+		if (!removed[i]) {
+			free_[kept++] = free_[i];
+		}
+	}
+	free_.resize(kept);
+}
+
+namespace {
+
+// Places as many of `order` as fit, in order; returns the placed indices.
+std::vector<size_t> packBin(MaxRectsBin& bin, const std::vector<std::pair<int, int>>& sizes, const std::vector<size_t>& order,
+							int padding, std::vector<PackPlacement>& placements) {
+	std::vector<size_t> placed;
+	for (size_t index : order) {
+		PackPlacement placement;
+		if (bin.insert(sizes[index].first + padding, sizes[index].second + padding, placement)) {
+			placements[index] = placement;
+			placed.push_back(index);
+		}
+	}
+	return placed;
+}
+
+// Powers of two up to the maximum; without the power of two rule also sixteenths of the maximum, since
+// the page is cropped to its used area afterwards anyway.
+std::vector<int> pageSizes(int maxSize, bool powerOfTwo) {
+	std::vector<int> result;
+	for (int size = 1; size <= maxSize && size > 0; size *= 2) {
+		result.push_back(size);
+	}
+	if (!powerOfTwo) {
+		for (int step = 1; step <= 16; ++step) {
+			result.push_back(std::max(1, maxSize * step / 16));
+		}
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+	return result;
+}
+
+// One packing with a fixed rule and order; `remaining` is consumed.
+std::vector<PackedPage> packPages(const std::vector<std::pair<int, int>>& sizes, const PackSettings& settings, FitRule rule,
+								  const std::vector<std::pair<int, int>>& candidates, std::vector<size_t> remaining,
+								  std::vector<PackPlacement>& placements) {
+	int pageWidth = candidates.back().first;
+	int pageHeight = candidates.back().second;
+	int padding = std::max(0, settings.padding);
+	std::vector<PackedPage> pages;
+	while (!remaining.empty()) {
+		// What fits on a full page goes on this page; then find the smallest page that still holds it all.
+		MaxRectsBin full(pageWidth + padding, pageHeight + padding, settings.allowRotation, rule);
+		std::vector<size_t> onPage = packBin(full, sizes, remaining, padding, placements);
+		long long area = 0;
+		for (size_t index : onPage) {
+			area += static_cast<long long>(sizes[index].first + padding) * (sizes[index].second + padding);
+		}
+
+		PackedPage page;
+		for (const auto& [width, height] : candidates) {
+			if (static_cast<long long>(width + padding) * (height + padding) < area) {
+				continue;
+			}
+			if (width == pageWidth && height == pageHeight) {
+				page.width = settings.powerOfTwo ? width : std::max(1, full.usedWidth() - padding);
+				page.height = settings.powerOfTwo ? height : std::max(1, full.usedHeight() - padding);
+				break;
+			}
+			MaxRectsBin bin(width + padding, height + padding, settings.allowRotation, rule);
+			std::vector<PackPlacement> trial(sizes.size());
+			if (packBin(bin, sizes, onPage, padding, trial).size() != onPage.size()) {
+				continue;
+			}
+			for (size_t index : onPage) {
+				placements[index] = trial[index];
+			}
+			page.width = settings.powerOfTwo ? width : std::max(1, bin.usedWidth() - padding);
+			page.height = settings.powerOfTwo ? height : std::max(1, bin.usedHeight() - padding);
+			break;
+		}
+
+		int pageIndex = static_cast<int>(pages.size());
+		for (size_t index : onPage) {
+			placements[index].page = pageIndex;
+		}
+		pages.push_back(page);
+
+		std::vector<char> placed(sizes.size(), 0);
+		for (size_t index : onPage) {
+			placed[index] = 1;
+		}
+		remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](size_t index) { return placed[index] != 0; }),
+						remaining.end());
+	}
+	return pages;
+}
+
+} // namespace
+
+std::vector<PackedPage> packRects(const std::vector<std::pair<int, int>>& sizes, const PackSettings& settings,
+								  std::vector<PackPlacement>& placements) {
+	placements.assign(sizes.size(), PackPlacement());
+	std::vector<int> widths = pageSizes(settings.maxWidth, settings.powerOfTwo);
+	std::vector<int> heights = pageSizes(settings.maxHeight, settings.powerOfTwo);
+	if (widths.empty() || heights.empty()) {
+		return {};
+	}
+	int pageWidth = widths.back();
+	int pageHeight = heights.back();
+
+	std::vector<size_t> indices;
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		const auto& [width, height] = sizes[i];
+		if (width <= 0 || height <= 0) {
+			placements[i].page = 0;
+			continue;
+		}
+		bool fits = (width <= pageWidth && height <= pageHeight) ||
+			(settings.allowRotation && height <= pageWidth && width <= pageHeight);
+		if (!fits) {
+			return {};
+		}
+		indices.push_back(i);
+	}
+	if (indices.empty()) {
+		return { { 1, 1 } };
+	}
+
+	// Smallest area first, the full page last.
+	std::vector<std::pair<int, int>> candidates;
+	for (int width : widths) {
+		for (int height : heights) {
+			candidates.emplace_back(width, height);
+		}
+	}
+	std::stable_sort(candidates.begin(), candidates.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+		long long areaA = static_cast<long long>(a.first) * a.second;
+		long long areaB = static_cast<long long>(b.first) * b.second;
+		if (areaA != areaB) {
+			return areaA < areaB;
+		}
+		return std::max(a.first, a.second) < std::max(b.first, b.second);
+	});
+
+	std::vector<size_t> byLongSide = indices;
+	std::stable_sort(byLongSide.begin(), byLongSide.end(), [&](size_t a, size_t b) {
+		int longA = std::max(sizes[a].first, sizes[a].second);
+		int longB = std::max(sizes[b].first, sizes[b].second);
+		if (longA != longB) {
+			return longA > longB;
+		}
+		return std::min(sizes[a].first, sizes[a].second) > std::min(sizes[b].first, sizes[b].second);
+	});
+	std::vector<size_t> byArea = indices;
+	std::stable_sort(byArea.begin(), byArea.end(), [&](size_t a, size_t b) {
+		return static_cast<long long>(sizes[a].first) * sizes[a].second > static_cast<long long>(sizes[b].first) * sizes[b].second;
+	});
+
+	std::vector<PackedPage> best;
+	long long bestArea = 0;
+	for (FitRule rule : { FitRule::ShortSide, FitRule::Area, FitRule::BottomLeft }) {
+		for (const auto* order : { &byLongSide, &byArea }) {
+			std::vector<PackPlacement> trial = placements;
+			std::vector<PackedPage> pages = packPages(sizes, settings, rule, candidates, *order, trial);
+			long long area = 0;
+			for (const auto& page : pages) {
+				area += static_cast<long long>(page.width) * page.height;
+			}
+			if (best.empty() || pages.size() < best.size() || (pages.size() == best.size() && area < bestArea)) {
+				best = pages;
+				bestArea = area;
+				placements = trial;
+			}
+		}
+	}
+	return best;
+}
@@ -0,0 +1,242 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace {
+
+constexpr size_t optimizerCacheSize = 32; // LRU cache modelled by the Forsyth scores
+constexpr size_t reportCacheSize = 16;    // FIFO cache used to report misses, closer to real hardware
+constexpr size_t noTriangle = std::numeric_limits<size_t>::max();
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation": recently used vertices score high, except the
+// three of the last triangle, and vertices with few remaining triangles are boosted so that they are
+// finished off instead of leaving isolated triangles behind.
+float vertexScore(int cachePosition, size_t remaining) {
+    if (remaining == 0) return -1.0f;
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = 0.75f;
+        } else {
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (optimizerCacheSize - 3), 1.5f);
+        }
+    }
+    return score + 2.0f * std::pow(static_cast<float>(remaining), -0.5f);
+}
+
+std::vector<unsigned short> optimizeTriangleOrder(const std::vector<unsigned short>& triangles, size_t vertexCount) {
+    size_t triangleCount = triangles.size() / 3;
+    std::vector<std::vector<size_t>> vertexTriangles(vertexCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (size_t k = 0; k < 3; ++k) vertexTriangles[triangles[t * 3 + k]].push_back(t);
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) score[v] = vertexScore(-1, vertexTriangles[v].size());
+    auto triangleScore = [&](size_t t) {
+        return score[triangles[t * 3]] + score[triangles[t * 3 + 1]] + score[triangles[t * 3 + 2]];
+    };
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<size_t> cache;
+    std::vector<unsigned short> result;
+    result.reserve(triangles.size());
+    size_t best = noTriangle;
+    for (size_t n = 0; n < triangleCount; ++n) {
+        // Nothing in the cache has triangles left: restart from the best triangle anywhere.
+        if (best == noTriangle) {
+            float bestScore = -std::numeric_limits<float>::max();
+            for (size_t t = 0; t < triangleCount; ++t) {
+                if (emitted[t]) continue;
+                float s = triangleScore(t);
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+
+        emitted[best] = true;
+        std::vector<size_t> touched;
+        for (size_t k = 0; k < 3; ++k) {
+            size_t v = triangles[best * 3 + k];
+            result.push_back(triangles[best * 3 + k]);
+            auto& adjacent = vertexTriangles[v];
+            auto it = std::find(adjacent.begin(), adjacent.end(), best);
+            if (it != adjacent.end()) adjacent.erase(it);
+            if (std::find(touched.begin(), touched.end(), v) == touched.end()) touched.push_back(v);
+        }
+        for (size_t v : cache)
+            if (std::find(touched.begin(), touched.end(), v) == touched.end()) touched.push_back(v);
+        // touched now lists the new LRU order; entries past the cache size fall out.
+        for (size_t i = 0; i < touched.size(); ++i) {
+            size_t v = touched[i];
+            cachePosition[v] = i < optimizerCacheSize ? static_cast<int>(i) : -1;
+            score[v] = vertexScore(cachePosition[v], vertexTriangles[v].size());
+        }
+        cache.assign(touched.begin(), touched.begin() + std::min(touched.size(), optimizerCacheSize));
+
+        best = noTriangle;
+        float bestScore = -std::numeric_limits<float>::max();
+        for (size_t v : cache) {
+            for (size_t t : vertexTriangles[v]) {
+                float s = triangleScore(t);
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+size_t countCacheMisses(const std::vector<unsigned short>& triangles) {
+    std::deque<unsigned short> cache;
+    size_t misses = 0;
+    for (unsigned short index : triangles) {
+        if (std::find(cache.begin(), cache.end(), index) != cache.end()) continue;
+        ++misses;
+        cache.push_back(index);
+        if (cache.size() > reportCacheSize) cache.pop_front();
+    }
+    return misses;
+}
+
+// New index of every vertex: hull vertices keep their place at the front, as the formats require,
+// the others are numbered in order of first use by the triangles. Unused vertices go last.
+std::vector<size_t> firstUseOrder(const std::vector<unsigned short>& triangles, size_t vertexCount, size_t hullCount) {
+    const size_t unassigned = std::numeric_limits<size_t>::max();
+    std::vector<size_t> remap(vertexCount, unassigned);
+    size_t next = 0;
+    for (; next < hullCount; ++next) remap[next] = next;
+    for (unsigned short index : triangles)
+        if (remap[index] == unassigned) remap[index] = next++;
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (remap[v] == unassigned) remap[v] = next++;
+    return remap;
+}
+
+// Float index in the vertex (or, for weighted meshes, influence) array after remapping vertices,
+// for every float index before. Deform frames use the same layout at two floats per entry.
+std::vector<size_t> remapVertexFloats(const std::vector<size_t>& remap, const std::vector<size_t>& entryCounts, size_t floatsPerEntry) {
+    size_t vertexCount = remap.size();
+    std::vector<size_t> oldStart(vertexCount + 1, 0), order(vertexCount), newStart(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        oldStart[v + 1] = oldStart[v] + entryCounts[v] * floatsPerEntry;
+        order[remap[v]] = v;
+    }
+    size_t position = 0;
+    for (size_t v : order) {
+        newStart[v] = position;
+        position += entryCounts[v] * floatsPerEntry;
+    }
+    std::vector<size_t> floats(oldStart[vertexCount]);
+    for (size_t v = 0; v < vertexCount; ++v)
+        for (size_t i = oldStart[v]; i < oldStart[v + 1]; ++i) floats[i] = newStart[v] + (i - oldStart[v]);
+    return floats;
+}
+
+void remapDeformFrame(TimelineFrame& frame, const std::vector<size_t>& floats) {
+    if (frame.vertices.empty()) return;
+    size_t first = std::numeric_limits<size_t>::max(), last = 0;
+    for (size_t i = 0; i < frame.vertices.size(); ++i) {
+        size_t index = static_cast<size_t>(frame.int1) + i;
+        if (index >= floats.size()) continue;
+        first = std::min(first, floats[index]);
+        last = std::max(last, floats[index]);
+    }
+    if (first > last) return;
+    std::vector<float> vertices(last - first + 1, 0.0f);
+    for (size_t i = 0; i < frame.vertices.size(); ++i) {
+        size_t index = static_cast<size_t>(frame.int1) + i;
+        if (index < floats.size()) vertices[floats[index] - first] = frame.vertices[i];
+    }
+    frame.int1 = static_cast<int>(first);
+    frame.vertices = std::move(vertices);
+}
+
+void reorderVertices(MeshAttachment& mesh, const std::vector<size_t>& remap, const std::vector<Timeline*>* deforms) {
+    size_t vertexCount = remap.size();
+    bool weighted = mesh.vertices.size() != mesh.uvs.size();
+
+    // Influences per vertex in storage order; one "influence" per vertex when unweighted.
+    std::vector<size_t> influences(vertexCount, 1);
+    if (weighted) {
+        size_t i = 0;
+        for (size_t v = 0; v < vertexCount && i < mesh.vertices.size(); ++v) {
+            influences[v] = static_cast<size_t>(mesh.vertices[i]);
+            i += 1 + influences[v] * 4;
+        }
+    }
+
+    std::vector<float> uvs(mesh.uvs.size());
+    for (size_t v = 0; v < vertexCount; ++v) {
+        uvs[remap[v] * 2] = mesh.uvs[v * 2];
+        uvs[remap[v] * 2 + 1] = mesh.uvs[v * 2 + 1];
+    }
+    mesh.uvs = std::move(uvs);
+
+    if (weighted) {
+        // Weighted vertices are stored as boneCount followed by four floats per bone.
+        std::vector<size_t> blockSizes(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) blockSizes[v] = 1 + influences[v] * 4;
+        std::vector<size_t> floats = remapVertexFloats(remap, blockSizes, 1);
+        std::vector<float> vertices(mesh.vertices.size());
+        for (size_t i = 0; i < floats.size() && i < mesh.vertices.size(); ++i) vertices[floats[i]] = mesh.vertices[i];
+        mesh.vertices = std::move(vertices);
+    } else {
+        std::vector<float> vertices(mesh.vertices.size());
+        for (size_t v = 0; v < vertexCount; ++v) {
+            vertices[remap[v] * 2] = mesh.vertices[v * 2];
+            vertices[remap[v] * 2 + 1] = mesh.vertices[v * 2 + 1];
+        }
+        mesh.vertices = std::move(vertices);
+    }
+
+    for (auto& index : mesh.triangles) index = static_cast<unsigned short>(remap[index]);
+    // Edges are stored as vertex index * 2.
+    for (auto& index : mesh.edges)
+        if (index / 2 < vertexCount) index = static_cast<unsigned short>(remap[index / 2] * 2 + index % 2);
+
+    if (deforms) {
+        std::vector<size_t> floats = remapVertexFloats(remap, influences, 2);
+        for (Timeline* timeline : *deforms)
+            for (auto& frame : *timeline) remapDeformFrame(frame, floats);
+    }
+}
+
+}
+
+MeshOptimizeStats optimizeMeshes(SkeletonData& skeleton, bool reorderMeshVertices) {
+    MeshOptimizeStats stats;
+    auto deforms = reorderMeshVertices ? collectDeformTimelines(skeleton) : std::map<const Attachment*, std::vector<Timeline*>>();
+    for (auto& skin : skeleton.skins) {
+        for (auto& [slotName, slot] : skin.attachments) {
+            for (auto& [attachmentName, attachment] : slot) {
+                auto* mesh = std::get_if<MeshAttachment>(&attachment.data);
+                if (!mesh || mesh->triangles.size() < 6) continue;
+                size_t vertexCount = mesh->uvs.size() / 2;
+                bool validIndices = std::all_of(mesh->triangles.begin(), mesh->triangles.end(), [&](unsigned short index) {
+                    return index < vertexCount;
+                });
+                if (!validIndices) continue;
+
+                stats.meshes++;
+                stats.triangles += mesh->triangles.size() / 3;
+                stats.missesBefore += countCacheMisses(mesh->triangles);
+                mesh->triangles = optimizeTriangleOrder(mesh->triangles, vertexCount);
+                stats.missesAfter += countCacheMisses(mesh->triangles);
+
+                if (reorderMeshVertices && static_cast<size_t>(mesh->hullLength) <= vertexCount) {
+                    auto deformIt = deforms.find(&attachment);
+                    reorderVertices(*mesh, firstUseOrder(mesh->triangles, vertexCount, mesh->hullLength),
+                                    deformIt == deforms.end() ? nullptr : &deformIt->second);
+                }
+            }
+        }
+    }
+    return stats;
+}
@@ -25,4 +25,46 @@ void convertOrder42ToBelow(SkeletonData& skeleton) {
         if (it != orders.end())
             path.order = std::distance(orders.begin(), it);
     }
-}
\ No newline at end of file
+}
+void compactConstraintOrders(SkeletonData& skeleton) {
+    std::vector<size_t> orders;
+    for (auto& ik : skeleton.ikConstraints)
+        orders.push_back(ik.order);
+    for (auto& transform : skeleton.transformConstraints)
+        orders.push_back(transform.order);
+    for (auto& path : skeleton.pathConstraints)
+        orders.push_back(path.order);
+    for (auto& physics : skeleton.physicsConstraints)
+        orders.push_back(physics.order);
+    std::sort(orders.begin(), orders.end());
+    orders.erase(std::unique(orders.begin(), orders.end()), orders.end());
+    auto rank = [&](size_t& order) {
+        order = std::distance(orders.begin(), std::lower_bound(orders.begin(), orders.end(), order));
+    };
+    for (auto& ik : skeleton.ikConstraints)
+        rank(ik.order);
+    for (auto& transform : skeleton.transformConstraints)
+        rank(transform.order);
+    for (auto& path : skeleton.pathConstraints)
+        rank(path.order);
+    for (auto& physics : skeleton.physicsConstraints)
+        rank(physics.order);
+}
+
+bool constraintOrdersDense(const SkeletonData& skeleton, bool includePhysics) {
+    std::vector<size_t> orders;
+    for (const auto& ik : skeleton.ikConstraints)
+        orders.push_back(ik.order);
+    for (const auto& transform : skeleton.transformConstraints)
+        orders.push_back(transform.order);
+    for (const auto& path : skeleton.pathConstraints)
+        orders.push_back(path.order);
+    if (includePhysics)
+        for (const auto& physics : skeleton.physicsConstraints)
+            orders.push_back(physics.order);
+    std::sort(orders.begin(), orders.end());
+    for (size_t i = 0; i < orders.size(); i++)
+        if (orders[i] != i)
+            return false;
+    return true;
+}
@@ -0,0 +1,415 @@
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr size_t windowSize = 32768;
+constexpr size_t hashSize = 16384;
+constexpr size_t maxMatch = 258;
+constexpr size_t noPosition = static_cast<size_t>(-1);
+constexpr size_t idatChunkSize = 1 << 16;
+constexpr size_t parallelChunkSize = 1 << 18;  // filtered bytes compressed by one thread
+
+const unsigned short lengthBase[] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258,259 };
+const unsigned char lengthExtra[] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+const unsigned short distanceBase[] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577,32768 };
+const unsigned char distanceExtra[] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+uint32_t reverseBits(uint32_t code, int count) {
+	uint32_t result = 0;
+	while (count--) {
+		result = (result << 1) | (code & 1);
+		code >>= 1;
+	}
+	return result;
+}
+
+// Same hash as stb_image_write, so matches are found at the same places.
+uint32_t hash3(const unsigned char* data) {
+	uint32_t hash = data[0] + (data[1] << 8) + (data[2] << 16);
+	hash ^= hash << 3;
+	hash += hash >> 5;
+	hash ^= hash << 4;
+	hash += hash >> 17;
+	hash ^= hash << 25;
+	hash += hash >> 6;
+	return hash & (hashSize - 1);
+}
+
+uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size) {
+	static const std::array<uint32_t, 256> table = [] {
+		std::array<uint32_t, 256> values{};
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; ++k) {
+				c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			}
+			values[i] = c;
+		}
+		return values;
+	}();
+	crc = ~crc;
+	for (size_t i = 0; i < size; ++i) {
+		crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+void putBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+	out.push_back(static_cast<unsigned char>(value >> 24));
+	out.push_back(static_cast<unsigned char>(value >> 16));
+	out.push_back(static_cast<unsigned char>(value >> 8));
+	out.push_back(static_cast<unsigned char>(value));
+}
+
+unsigned char paeth(int a, int b, int c) {
+	int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+	if (pa <= pb && pa <= pc) return static_cast<unsigned char>(a);
+	if (pb <= pc) return static_cast<unsigned char>(b);
+	return static_cast<unsigned char>(c);
+}
+
+// PNG filter `type` of one row; `prior` is the previous row, all zeros for the first one.
+void filterRow(int type, const unsigned char* row, const unsigned char* prior, size_t size, int bpp, unsigned char* out) {
+	size_t first = std::min(size, static_cast<size_t>(bpp));
+	switch (type) {
+		case 0:
+			std::memcpy(out, row, size);
+			break;
+		case 1:
+			std::memcpy(out, row, first);
+			for (size_t i = first; i < size; ++i) out[i] = static_cast<unsigned char>(row[i] - row[i - bpp]);
+			break;
+		case 2:
+			for (size_t i = 0; i < size; ++i) out[i] = static_cast<unsigned char>(row[i] - prior[i]);
+			break;
+		case 3:
+			for (size_t i = 0; i < first; ++i) out[i] = static_cast<unsigned char>(row[i] - (prior[i] >> 1));
+			for (size_t i = first; i < size; ++i) out[i] = static_cast<unsigned char>(row[i] - ((row[i - bpp] + prior[i]) >> 1));
+			break;
+		case 4:
+			for (size_t i = 0; i < first; ++i) out[i] = static_cast<unsigned char>(row[i] - prior[i]);
+			for (size_t i = first; i < size; ++i) out[i] = static_cast<unsigned char>(row[i] - paeth(row[i - bpp], prior[i], prior[i - bpp]));
+			break;
+	}
+}
+
+} // namespace
+
+ZlibStream::ZlibStream(int quality, bool zlibHeader)
+	: quality_(std::max(quality, 1)), head_(hashSize, noPosition), previous_(windowSize, noPosition) {
+	if (zlibHeader) {
+		output_.push_back(0x78);  // DEFLATE 32K window
+		output_.push_back(0x5e);  // FLEVEL = 1
+	}
+}
+
+void ZlibStream::addInput(const unsigned char* data, size_t size) {
+	for (size_t i = 0; i < size;) {
+		size_t block = std::min<size_t>(size - i, 5552);
+		for (size_t k = 0; k < block; ++k) {
+			adlerA_ += data[i + k];
+			adlerB_ += adlerA_;
+		}
+		adlerA_ %= 65521;
+		adlerB_ %= 65521;
+		i += block;
+	}
+	window_.insert(window_.end(), data, data + size);
+}
+
+void ZlibStream::write(const unsigned char* data, size_t size) {
+	addInput(data, size);
+	encode(false);
+	// Keep one window of history before the next byte to encode.
+	if (position_ - base_ > 2 * windowSize) {
+		size_t drop = position_ - windowSize - base_;
+		window_.erase(window_.begin(), window_.begin() + drop);
+		base_ += drop;
+	}
+}
+
+void ZlibStream::flush() {
+	encode(true);
+	if (blockOpen_) addHuffman(256);  // end of block
+	blockOpen_ = false;
+	addBits(0, 3);                    // BFINAL = 0, BTYPE = 0: stored
+	if (bitCount_ > 0) addBits(0, 8 - bitCount_);
+	output_.insert(output_.end(), { 0x00, 0x00, 0xff, 0xff });  // LEN = 0, NLEN
+}
+
+void ZlibStream::setDictionary(const unsigned char* data, size_t size) {
+	if (position_ != 0 || !window_.empty()) {
+		throw std::logic_error("ZlibStream::setDictionary needs a new stream");
+	}
+	if (size > windowSize) {
+		data += size - windowSize;
+		size = windowSize;
+	}
+	window_.assign(data, data + size);
+	for (size_t position = 0; position + 3 <= size; ++position) insert(position);
+	position_ = size;
+}
+
+void ZlibStream::appendFlushed(const std::vector<unsigned char>& blocks, const unsigned char* data, size_t size) {
+	if (blockOpen_ || bitCount_ != 0 || position_ != base_ + window_.size()) {
+		throw std::logic_error("ZlibStream::appendFlushed needs a flushed stream");
+	}
+	output_.insert(output_.end(), blocks.begin(), blocks.end());
+	addInput(data, size);
+	position_ = base_ + window_.size();
+	if (window_.size() > windowSize) {
+		size_t drop = window_.size() - windowSize;
+		window_.erase(window_.begin(), window_.begin() + drop);
+		base_ += drop;
+	}
+}
+
+void ZlibStream::finish() {
+	encode(true);
+	if (blockOpen_) addHuffman(256);
+	blockOpen_ = false;
+	addBits(1, 1);    // BFINAL = 1, an empty fixed Huffman block
+	addBits(1, 2);
+	addHuffman(256);
+	if (bitCount_ > 0) addBits(0, 8 - bitCount_);
+	putBigEndian(output_, (adlerB_ << 16) | adlerA_);
+}
+
+void ZlibStream::openBlock() {
+	if (blockOpen_) return;
+	addBits(0, 1);    // BFINAL = 0
+	addBits(1, 2);    // BTYPE = 1, fixed Huffman
+	blockOpen_ = true;
+}
+
+void ZlibStream::insert(size_t position) {
+	uint32_t hash = hash3(&window_[position - base_]);
+	previous_[position % windowSize] = head_[hash];
+	head_[hash] = position;
+}
+
+// Longest match at `position` among the last 2 * quality positions with the same hash.
+size_t ZlibStream::findMatch(size_t position, size_t& distance) const {
+	size_t end = base_ + window_.size();
+	size_t limit = std::min(maxMatch, end - position);
+	const unsigned char* current = &window_[position - base_];
+	size_t best = 0;
+	size_t candidate = head_[hash3(current)];
+	for (int chain = 0; chain < 2 * quality_ && candidate != noPosition && candidate < position; ++chain) {
+		if (position - candidate >= windowSize || candidate < base_) break;
+		const unsigned char* match = &window_[candidate - base_];
+		size_t length = 0;
+		while (length < limit && match[length] == current[length]) ++length;
+		if (length > best) {
+			best = length;
+			distance = position - candidate;
+		}
+		size_t next = previous_[candidate % windowSize];
+		if (next >= candidate) break;
+		candidate = next;
+	}
+	return best;
+}
+
+void ZlibStream::encode(bool flushAll) {
+	size_t end = base_ + window_.size();
+	// Without flushAll, keep enough lookahead for a full match at the next position too.
+	size_t stop = flushAll ? (end > 3 ? end - 3 : 0) : (end > maxMatch + 1 ? end - maxMatch - 1 : 0);
+	if (position_ < (flushAll ? end : stop)) openBlock();
+	while (position_ < stop) {
+		size_t distance = 0;
+		size_t best = findMatch(position_, distance);
+		insert(position_);
+		if (best >= 3) {
+			// Lazy matching: emit a literal if the next position has a longer match.
+			size_t nextDistance = 0;
+			if (findMatch(position_ + 1, nextDistance) > best) best = 0;
+		}
+		if (best >= 3) {
+			addLength(best, distance);
+			position_ += best;
+		} else {
+			addHuffman(window_[position_ - base_]);
+			++position_;
+		}
+	}
+	if (flushAll) {
+		for (; position_ < end; ++position_) addHuffman(window_[position_ - base_]);
+	}
+}
+
+void ZlibStream::addBits(uint32_t code, int count) {
+	bitBuffer_ |= code << bitCount_;
+	bitCount_ += count;
+	while (bitCount_ >= 8) {
+		output_.push_back(static_cast<unsigned char>(bitBuffer_));
+		bitBuffer_ >>= 8;
+		bitCount_ -= 8;
+	}
+}
+
+void ZlibStream::addHuffman(int symbol) {
+	if (symbol <= 143) addBits(reverseBits(0x30 + symbol, 8), 8);
+	else if (symbol <= 255) addBits(reverseBits(0x190 + symbol - 144, 9), 9);
+	else if (symbol <= 279) addBits(reverseBits(symbol - 256, 7), 7);
+	else addBits(reverseBits(0xc0 + symbol - 280, 8), 8);
+}
+
+void ZlibStream::addLength(size_t length, size_t distance) {
+	int j = 0;
+	while (length > static_cast<size_t>(lengthBase[j + 1] - 1)) ++j;
+	addHuffman(j + 257);
+	if (lengthExtra[j]) addBits(static_cast<uint32_t>(length - lengthBase[j]), lengthExtra[j]);
+	j = 0;
+	while (distance > static_cast<size_t>(distanceBase[j + 1] - 1)) ++j;
+	addBits(reverseBits(j, 5), 5);
+	if (distanceExtra[j]) addBits(static_cast<uint32_t>(distance - distanceBase[j]), distanceExtra[j]);
+}
+
+PngStreamWriter::PngStreamWriter(const std::string& path, int width, int height, int channels, PngLevel level, unsigned int threads)
+	: file_(path, std::ios::binary | std::ios::trunc), width_(width), height_(height), channels_(channels),
+	  rowSize_(static_cast<size_t>(width) * channels),
+	  quality_(level == PngLevel::Fast ? 2 : level == PngLevel::Max ? 32 : 8),
+	  forcedFilter_(level == PngLevel::Fast ? 4 : -1),
+	  threads_(std::max(1u, threads)),
+	  previousRow_(rowSize_, 0),
+	  chunkRows_(std::max<size_t>(1, parallelChunkSize / (rowSize_ + 1))),
+	  zlib_(quality_) {
+	static const unsigned char signature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+	static const unsigned char colorTypes[] = { 0, 0, 4, 2, 6 };
+	file_.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+	std::vector<unsigned char> header;
+	putBigEndian(header, static_cast<uint32_t>(width));
+	putBigEndian(header, static_cast<uint32_t>(height));
+	header.push_back(8);
+	header.push_back(colorTypes[channels]);
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	writeChunk("IHDR", header.data(), header.size());
+}
+
+// Filter byte plus filtered row for each of `rowCount` contiguous rows; `prior` is the row before them.
+void PngStreamWriter::filterRows(const unsigned char* rows, size_t rowCount, const unsigned char* prior, unsigned char* out) const {
+	std::vector<unsigned char> candidate(rowSize_);
+	for (size_t r = 0; r < rowCount; ++r) {
+		const unsigned char* row = rows + r * rowSize_;
+		const unsigned char* previous = r == 0 ? prior : row - rowSize_;
+		unsigned char* filtered = out + r * (rowSize_ + 1);
+		if (forcedFilter_ >= 0) {
+			filtered[0] = static_cast<unsigned char>(forcedFilter_);
+			filterRow(forcedFilter_, row, previous, rowSize_, channels_, filtered + 1);
+			continue;
+		}
+		// Estimate each filter's entropy by the sum of absolute signed bytes; the lowest wins.
+		long bestEstimate = -1;
+		for (int type = 0; type < 5; ++type) {
+			filterRow(type, row, previous, rowSize_, channels_, candidate.data());
+			long estimate = 0;
+			for (unsigned char value : candidate) estimate += std::abs(static_cast<signed char>(value));
+			if (bestEstimate < 0 || estimate < bestEstimate) {
+				bestEstimate = estimate;
+				filtered[0] = static_cast<unsigned char>(type);
+				std::copy(candidate.begin(), candidate.end(), filtered + 1);
+			}
+		}
+	}
+}
+
+void PngStreamWriter::writeRows(const unsigned char* rows, int rowCount, size_t stride) {
+	for (int r = 0; r < rowCount; ++r) {
+		const unsigned char* row = rows + r * stride;
+		batch_.insert(batch_.end(), row, row + rowSize_);
+		++rowsWritten_;
+	}
+	if (batch_.size() >= chunkRows_ * threads_ * rowSize_) compressBatch(false);
+	flushData(false);
+}
+
+// Filters and compresses the batched rows in chunks of chunkRows_ rows counted from the top of the image,
+// one chunk per thread at a time; rows short of a full chunk wait for the next batch unless `all`. Each
+// chunk is compressed on its own with the 32K of filtered data before it as dictionary, so the output is
+// the same for any number of threads.
+void PngStreamWriter::compressBatch(bool all) {
+	size_t rowCount = rowSize_ > 0 ? batch_.size() / rowSize_ : 0;
+	size_t chunkCount = all ? (rowCount + chunkRows_ - 1) / chunkRows_ : rowCount / chunkRows_;
+	if (chunkCount == 0) return;
+	rowCount = std::min(rowCount, chunkCount * chunkRows_);
+	std::vector<std::vector<unsigned char>> filtered(chunkCount), compressed(chunkCount);
+	auto run = [&](auto task) {
+		std::atomic<size_t> next = 0;
+		auto worker = [&]() {
+			for (size_t c = next++; c < chunkCount; c = next++) task(c);
+		};
+		std::vector<std::thread> threads;
+		for (unsigned int i = 1; i < std::min<size_t>(threads_, chunkCount); ++i) threads.emplace_back(worker);
+		worker();
+		for (auto& thread : threads) thread.join();
+	};
+
+	run([&](size_t c) {
+		size_t first = c * chunkRows_;
+		size_t count = std::min(chunkRows_, rowCount - first);
+		const unsigned char* rows = batch_.data() + first * rowSize_;
+		filtered[c].resize(count * (rowSize_ + 1));
+		filterRows(rows, count, first == 0 ? previousRow_.data() : rows - rowSize_, filtered[c].data());
+	});
+	// Chunk c's dictionary is the end of the filtered data before it, the last one carries over to the next batch.
+	std::vector<std::vector<unsigned char>> dictionaries(chunkCount + 1);
+	dictionaries[0] = std::move(dictionary_);
+	for (size_t c = 0; c < chunkCount; ++c) {
+		const std::vector<unsigned char>& previous = dictionaries[c];
+		const std::vector<unsigned char>& data = filtered[c];
+		size_t fromData = std::min(windowSize, data.size());
+		size_t fromPrevious = std::min(windowSize - fromData, previous.size());
+		dictionaries[c + 1].assign(previous.end() - fromPrevious, previous.end());
+		dictionaries[c + 1].insert(dictionaries[c + 1].end(), data.end() - fromData, data.end());
+	}
+	run([&](size_t c) {
+		ZlibStream chunk(quality_, false);
+		chunk.setDictionary(dictionaries[c].data(), dictionaries[c].size());
+		chunk.write(filtered[c].data(), filtered[c].size());
+		chunk.flush();
+		compressed[c] = std::move(chunk.output());
+	});
+
+	for (size_t c = 0; c < chunkCount; ++c) zlib_.appendFlushed(compressed[c], filtered[c].data(), filtered[c].size());
+	dictionary_ = std::move(dictionaries[chunkCount]);
+	std::memcpy(previousRow_.data(), batch_.data() + (rowCount - 1) * rowSize_, rowSize_);
+	batch_.erase(batch_.begin(), batch_.begin() + rowCount * rowSize_);
+}
+
+bool PngStreamWriter::finish() {
+	compressBatch(true);
+	zlib_.finish();
+	flushData(true);
+	writeChunk("IEND", nullptr, 0);
+	file_.flush();
+	return rowsWritten_ == height_ && static_cast<bool>(file_);
+}
+
+void PngStreamWriter::flushData(bool all) {
+	std::vector<unsigned char>& data = zlib_.output();
+	while (data.size() >= idatChunkSize || (all && !data.empty())) {
+		size_t size = std::min(data.size(), idatChunkSize);
+		writeChunk("IDAT", data.data(), size);
+		data.erase(data.begin(), data.begin() + size);
+	}
+}
+
+void PngStreamWriter::writeChunk(const char* type, const unsigned char* data, size_t size) {
+	std::vector<unsigned char> chunk;
+	putBigEndian(chunk, static_cast<uint32_t>(size));
+	chunk.insert(chunk.end(), type, type + 4);
+	if (size > 0) chunk.insert(chunk.end(), data, data + size);
+	putBigEndian(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+	file_.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
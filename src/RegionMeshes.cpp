@@ -0,0 +1,201 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+struct Point {
+    double x, y;
+};
+
+double cross(const Point& o, const Point& a, const Point& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+double polygonArea(const std::vector<Point>& polygon) {
+    double area = 0.0;
+    for (size_t i = 0, n = polygon.size(); i < n; i++) {
+        const Point& a = polygon[i];
+        const Point& b = polygon[(i + 1) % n];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return std::abs(area) / 2.0;
+}
+
+// The region's alpha, or the union of its sequence frames' when they are all stored in the same
+// rectangle. Sets `missing` when a region is not in the atlas.
+bool attachmentAlpha(const std::string& path, const OptSequence& sequence, const std::map<std::string, RegionAlpha>& regions,
+                     RegionAlpha& result, bool& missing) {
+    int count = sequence ? sequence->count : 1;
+    for (int i = 0; i < count; i++) {
+        auto it = regions.find(sequence ? sequenceRegionName(path, *sequence, i) : path);
+        if (it == regions.end()) {
+            missing = true;
+            return false;
+        }
+        const RegionAlpha& frame = it->second;
+        if (i == 0) {
+            result = frame;
+            continue;
+        }
+        if (frame.originalWidth != result.originalWidth || frame.originalHeight != result.originalHeight ||
+            frame.left != result.left || frame.top != result.top || frame.width != result.width || frame.height != result.height)
+            return false;
+        for (size_t p = 0; p < result.alpha.size(); p++) result.alpha[p] = std::max(result.alpha[p], frame.alpha[p]);
+    }
+    return count > 0 && result.width > 0 && result.height > 0 &&
+           result.alpha.size() == static_cast<size_t>(result.width) * result.height;
+}
+
+// Convex hull (monotone chain) of the corners of the visible pixels, in pixels of the original image.
+// Only the outermost visible pixels of each row can be on it.
+std::vector<Point> visibleHull(const RegionAlpha& region, unsigned char threshold) {
+    std::vector<Point> points;
+    for (int y = 0; y < region.height; y++) {
+        const unsigned char* row = &region.alpha[static_cast<size_t>(y) * region.width];
+        int first = 0;
+        while (first < region.width && row[first] <= threshold) first++;
+        if (first == region.width) continue;
+        int last = region.width - 1;
+        while (row[last] <= threshold) last--;
+        double top = region.top + y;
+        double left = region.left + first;
+        double right = region.left + last + 1.0;
+        points.push_back({left, top});
+        points.push_back({left, top + 1.0});
+        points.push_back({right, top});
+        points.push_back({right, top + 1.0});
+    }
+    if (points.size() < 3) return {};
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+    std::vector<Point> hull(points.size() * 2);
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0.0) k--;
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0.0) k--;
+        hull[k++] = points[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+// Removes hull edges until at most maxVertices remain. Each step drops the edge whose neighbours,
+// extended to where they meet, add the least area, as long as that point stays inside the bounds;
+// the hull only ever grows, so it keeps covering every visible pixel. False if it cannot get there.
+bool reduceHull(std::vector<Point>& hull, size_t maxVertices, const Point& min, const Point& max) {
+    const double epsilon = 1e-6;
+    while (hull.size() > maxVertices) {
+        size_t n = hull.size();
+        size_t best = n;
+        double bestArea = std::numeric_limits<double>::max();
+        Point bestPoint = {0.0, 0.0};
+        for (size_t i = 0; i < n; i++) {
+            const Point& a = hull[(i + n - 1) % n];
+            const Point& b = hull[i];
+            const Point& c = hull[(i + 1) % n];
+            const Point& d = hull[(i + 2) % n];
+            // b + t (b - a) = c + s (c - d)
+            double dx1 = b.x - a.x, dy1 = b.y - a.y;
+            double dx2 = c.x - d.x, dy2 = c.y - d.y;
+            double denominator = dx1 * dy2 - dy1 * dx2;
+            if (std::abs(denominator) < epsilon) continue;
+            double t = ((c.x - b.x) * dy2 - (c.y - b.y) * dx2) / denominator;
+            double s = ((c.x - b.x) * dy1 - (c.y - b.y) * dx1) / denominator;
+            if (t < 0.0 || s < 0.0) continue;
+            Point p = {b.x + t * dx1, b.y + t * dy1};
+            if (p.x < min.x - epsilon || p.y < min.y - epsilon || p.x > max.x + epsilon || p.y > max.y + epsilon) continue;
+            double area = std::abs(cross(b, p, c)) / 2.0;
+            if (area < bestArea) {
+                bestArea = area;
+                best = i;
+                bestPoint = {std::clamp(p.x, min.x, max.x), std::clamp(p.y, min.y, max.y)};
+            }
+        }
+        if (best == n) return false;
+        hull[best] = bestPoint;
+        hull.erase(hull.begin() + (best + 1) % n);
+    }
+    return true;
+}
+
+// A mesh drawing the hull where the region attachment drew its quad: vertices go through the region's
+// width, height, scale, rotation and offset like its corners do. 3.5 and 3.6 runtimes map mesh UVs to
+// the stored rectangle, later ones to the original image.
+MeshAttachment hullMesh(const RegionAttachment& region, const RegionAlpha& alpha, const std::vector<Point>& hull, bool storedUVs) {
+    MeshAttachment mesh;
+    mesh.width = region.width * std::abs(region.scaleX);
+    mesh.height = region.height * std::abs(region.scaleY);
+    mesh.color = region.color;
+    mesh.sequence = region.sequence;
+    mesh.hullLength = static_cast<int>(hull.size());
+    double radians = region.rotation * 3.14159265358979323846 / 180.0;
+    double cosine = std::cos(radians), sine = std::sin(radians);
+    for (const Point& p : hull) {
+        double u = p.x / alpha.originalWidth;
+        double v = p.y / alpha.originalHeight;
+        double localX = (u - 0.5) * region.width * region.scaleX;
+        double localY = (0.5 - v) * region.height * region.scaleY;
+        mesh.vertices.push_back(static_cast<float>(localX * cosine - localY * sine + region.x));
+        mesh.vertices.push_back(static_cast<float>(localX * sine + localY * cosine + region.y));
+        if (storedUVs) {
+            u = (p.x - alpha.left) / alpha.width;
+            v = (p.y - alpha.top) / alpha.height;
+        }
+        mesh.uvs.push_back(static_cast<float>(u));
+        mesh.uvs.push_back(static_cast<float>(v));
+    }
+    for (size_t i = 1; i + 1 < hull.size(); i++) {
+        mesh.triangles.push_back(0);
+        mesh.triangles.push_back(static_cast<unsigned short>(i));
+        mesh.triangles.push_back(static_cast<unsigned short>(i + 1));
+    }
+    for (size_t i = 0; i < hull.size(); i++) {
+        mesh.edges.push_back(static_cast<unsigned short>(i * 2));
+        mesh.edges.push_back(static_cast<unsigned short>((i + 1) % hull.size() * 2));
+    }
+    return mesh;
+}
+
+}
+
+TightMeshStats tightenRegionAttachments(SkeletonData& skeleton, const std::map<std::string, RegionAlpha>& regions,
+                                        const TightMeshSettings& settings) {
+    TightMeshStats stats;
+    size_t maxVertices = static_cast<size_t>(std::max(3, settings.maxVertices));
+    bool storedUVs = skeleton.version && (skeleton.version->rfind("3.5", 0) == 0 || skeleton.version->rfind("3.6", 0) == 0);
+    for (auto& skin : skeleton.skins) {
+        for (auto& [slotName, slot] : skin.attachments) {
+            for (auto& [attachmentName, attachment] : slot) {
+                if (attachment.type != AttachmentType_Region) continue;
+                const RegionAttachment& region = std::get<RegionAttachment>(attachment.data);
+                RegionAlpha alpha;
+                bool missing = false;
+                if (!attachmentAlpha(attachment.path, region.sequence, regions, alpha, missing) ||
+                    alpha.originalWidth <= 0 || alpha.originalHeight <= 0) {
+                    (missing ? stats.missing : stats.unchanged)++;
+                    continue;
+                }
+                std::vector<Point> hull = visibleHull(alpha, settings.threshold);
+                Point min = {static_cast<double>(alpha.left), static_cast<double>(alpha.top)};
+                Point max = {static_cast<double>(alpha.left + alpha.width), static_cast<double>(alpha.top + alpha.height)};
+                double before = static_cast<double>(alpha.width) * alpha.height;
+                if (hull.size() < 3 || !reduceHull(hull, maxVertices, min, max) ||
+                    polygonArea(hull) > before * (1.0 - settings.minSaving)) {
+                    stats.unchanged++;
+                    continue;
+                }
+                stats.converted++;
+                stats.areaBefore += before;
+                stats.areaAfter += polygonArea(hull);
+                attachment.data = hullMesh(region, alpha, hull, storedUVs);
+                attachment.type = AttachmentType_Mesh;
+            }
+        }
+    }
+    return stats;
+}
@@ -7,18 +7,6 @@ namespace {
 constexpr float epsilon = 0.0001f;
 constexpr float max3xRotateDelta = 179.0f;
 
-struct BezierPoint {
-    float x = 0.0f;
-    float y = 0.0f;
-};
-
-float normalizeRotationDelta(float delta) {
-    delta = std::fmod(delta, 360.0f);
-    if (delta > 180.0f) delta -= 360.0f;
-    if (delta < -180.0f) delta += 360.0f;
-    return delta;
-}
-
 float resolveAmbiguousHalfTurn(float delta, float previousDelta) {
     if (std::fabs(std::fabs(delta) - 180.0f) > epsilon) return delta;
     if (previousDelta > 0.0f) return 180.0f;
@@ -47,15 +35,6 @@ BezierPoint lerp(const BezierPoint& a, const BezierPoint& b, float t) {
     };
 }
 
-BezierPoint evaluateBezier(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float t) {
-    BezierPoint p01 = lerp(p0, p1, t);
-    BezierPoint p12 = lerp(p1, p2, t);
-    BezierPoint p23 = lerp(p2, p3, t);
-    BezierPoint p012 = lerp(p01, p12, t);
-    BezierPoint p123 = lerp(p12, p23, t);
-    return lerp(p012, p123, t);
-}
-
 TimelineFrame makeRotateFrame(float time, float value) {
     TimelineFrame frame;
     frame.time = time;
@@ -65,39 +44,8 @@ TimelineFrame makeRotateFrame(float time, float value) {
 }
 
 bool findBezierTForValue(const BezierPoint& p0, const BezierPoint& p1, const BezierPoint& p2, const BezierPoint& p3, float value, float& result) {
-    constexpr int samples = 100;
-    float previousT = 0.0f;
-    float previousY = p0.y - value;
-
-    for (int i = 1; i <= samples; ++i) {
-        float currentT = static_cast<float>(i) / samples;
-        float currentY = evaluateBezier(p0, p1, p2, p3, currentT).y - value;
-        if (std::fabs(currentY) <= epsilon) {
-            result = currentT;
-            return result > epsilon && result < 1.0f - epsilon;
-        }
-        if (previousY * currentY < 0.0f) {
-            float low = previousT;
-            float high = currentT;
-            for (int step = 0; step < 24; ++step) {
-                float mid = (low + high) * 0.5f;
-                float midY = evaluateBezier(p0, p1, p2, p3, mid).y - value;
-                if (previousY * midY <= 0.0f) {
-                    high = mid;
-                    currentY = midY;
-                } else {
-                    low = mid;
-                    previousY = midY;
-                }
-            }
-            result = (low + high) * 0.5f;
-            return result > epsilon && result < 1.0f - epsilon;
-        }
-        previousT = currentT;
-        previousY = currentY;
-    }
-
-    return false;
+    if (!findBezierTForY(p0, p1, p2, p3, value, result)) return false;
+    return result > epsilon && result < 1.0f - epsilon;
 }
 
 bool splitLinearRotateSegment(const TimelineFrame& start, const TimelineFrame& end, float value, TimelineFrame& leftStart, TimelineFrame& mid) {
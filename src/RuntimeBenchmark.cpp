@@ -0,0 +1,376 @@
+// Load-time and animation sampling benchmarks against the vendored spine-cpp runtimes.
+// Built once per runtime version; SPINE_RUNTIME_VERSION selects the API differences (37, 38, 40, 41, 42).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <spine/spine.h>
+
+#ifndef SPINE_RUNTIME_VERSION
+#error "SPINE_RUNTIME_VERSION must be defined (37, 38, 40, 41 or 42)"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Counts the runtime's allocations. Every block carries its size in front of it, so the bytes a loaded
+// skeleton keeps are known exactly, whatever the allocator reuses from earlier files.
+class CountingExtension : public spine::DefaultSpineExtension {
+public:
+	size_t allocations = 0;
+	size_t liveBytes = 0;
+
+protected:
+	static constexpr size_t headerSize = alignof(std::max_align_t);
+
+	void* _alloc(size_t size, const char*, int) override {
+		if (size == 0) {
+			return nullptr;
+		}
+		unsigned char* block = static_cast<unsigned char*>(::malloc(headerSize + size));
+		if (!block) {
+			return nullptr;
+		}
+		std::memcpy(block, &size, sizeof(size));
+		allocations++;
+		liveBytes += size;
+		return block + headerSize;
+	}
+
+	void* _calloc(size_t size, const char* file, int line) override {
+		void* ptr = _alloc(size, file, line);
+		if (ptr) {
+			std::memset(ptr, 0, size);
+		}
+		return ptr;
+	}
+
+	void* _realloc(void* ptr, size_t size, const char* file, int line) override {
+		if (size == 0) {
+			return nullptr;
+		}
+		if (!ptr) {
+			return _alloc(size, file, line);
+		}
+		unsigned char* block = static_cast<unsigned char*>(ptr) - headerSize;
+		size_t oldSize;
+		std::memcpy(&oldSize, block, sizeof(oldSize));
+		block = static_cast<unsigned char*>(::realloc(block, headerSize + size));
+		if (!block) {
+			return nullptr;
+		}
+		std::memcpy(block, &size, sizeof(size));
+		allocations++;
+		liveBytes += size;
+		liveBytes -= oldSize;
+		return block + headerSize;
+	}
+
+	void _free(void* mem, const char*, int) override {
+		if (!mem) {
+			return;
+		}
+		unsigned char* block = static_cast<unsigned char*>(mem) - headerSize;
+		size_t size;
+		std::memcpy(&size, block, sizeof(size));
+		liveBytes -= size;
+		::free(block);
+	}
+};
+
+CountingExtension* countingExtension = nullptr;
+
+} // namespace
+
+spine::SpineExtension* spine::getDefaultExtension() {
+	countingExtension = new CountingExtension();
+	return countingExtension;
+}
+
+namespace {
+
+// Creates attachments without texture regions so skeletons load without their atlas pages.
+// This isolates skeleton parsing from atlas parsing, which the conversions do not touch.
+class RegionlessAttachmentLoader : public spine::AttachmentLoader {
+public:
+#if SPINE_RUNTIME_VERSION >= 41
+	spine::RegionAttachment* newRegionAttachment(spine::Skin&, const spine::String& name, const spine::String&, spine::Sequence*) override {
+		return new (__FILE__, __LINE__) spine::RegionAttachment(name);
+	}
+
+	spine::MeshAttachment* newMeshAttachment(spine::Skin&, const spine::String& name, const spine::String&, spine::Sequence*) override {
+		return new (__FILE__, __LINE__) spine::MeshAttachment(name);
+	}
+#else
+	spine::RegionAttachment* newRegionAttachment(spine::Skin&, const spine::String& name, const spine::String&) override {
+		return new (__FILE__, __LINE__) spine::RegionAttachment(name);
+	}
+
+	spine::MeshAttachment* newMeshAttachment(spine::Skin&, const spine::String& name, const spine::String&) override {
+		return new (__FILE__, __LINE__) spine::MeshAttachment(name);
+	}
+#endif
+
+	spine::BoundingBoxAttachment* newBoundingBoxAttachment(spine::Skin&, const spine::String& name) override {
+		return new (__FILE__, __LINE__) spine::BoundingBoxAttachment(name);
+	}
+
+	spine::PathAttachment* newPathAttachment(spine::Skin&, const spine::String& name) override {
+		return new (__FILE__, __LINE__) spine::PathAttachment(name);
+	}
+
+	spine::PointAttachment* newPointAttachment(spine::Skin&, const spine::String& name) override {
+		return new (__FILE__, __LINE__) spine::PointAttachment(name);
+	}
+
+	spine::ClippingAttachment* newClippingAttachment(spine::Skin&, const spine::String& name) override {
+		return new (__FILE__, __LINE__) spine::ClippingAttachment(name);
+	}
+
+	void configureAttachment(spine::Attachment*) override {}
+};
+
+struct LoadResult {
+	spine::SkeletonData* skeletonData = nullptr;
+	std::string error;
+};
+
+// The content is NUL-terminated so SkeletonJson can parse it in place.
+bool readFile(const fs::path& path, std::vector<char>& out) {
+	std::ifstream ifs(path, std::ios::binary);
+	if (!ifs) {
+		return false;
+	}
+	out.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	out.push_back('\0');
+	return true;
+}
+
+LoadResult loadSkeletonData(spine::AttachmentLoader& loader, const fs::path& path, const std::vector<char>& content) {
+	LoadResult result;
+	if (path.extension() == ".skel") {
+		spine::SkeletonBinary binary(&loader);
+		result.skeletonData = binary.readSkeletonData(reinterpret_cast<const unsigned char*>(content.data()), static_cast<int>(content.size() - 1));
+		if (!binary.getError().isEmpty()) {
+			result.error = binary.getError().buffer();
+		}
+	} else {
+		spine::SkeletonJson json(&loader);
+		result.skeletonData = json.readSkeletonData(content.data());
+		if (!json.getError().isEmpty()) {
+			result.error = json.getError().buffer();
+		}
+	}
+	if (!result.skeletonData && result.error.empty()) {
+		result.error = "runtime returned no skeleton data";
+	}
+	return result;
+}
+
+bool benchmarkLoad(const fs::path& path, int iterations) {
+	std::vector<char> content;
+	if (!readFile(path, content)) {
+		std::cout << "[FAIL] " << path.string() << ": cannot read file" << std::endl;
+		return false;
+	}
+
+	RegionlessAttachmentLoader loader;
+	spine::SpineExtension::getInstance();
+	size_t allocationsBefore = countingExtension->allocations;
+	size_t bytesBefore = countingExtension->liveBytes;
+	LoadResult retained = loadSkeletonData(loader, path, content);
+	size_t allocations = countingExtension->allocations - allocationsBefore;
+	size_t retainedBytes = countingExtension->liveBytes - bytesBefore;
+	if (!retained.error.empty()) {
+		delete retained.skeletonData;
+		std::cout << "[FAIL] " << path.string() << ": " << retained.error << std::endl;
+		return false;
+	}
+
+	std::vector<double> timings;
+	for (int i = 0; i < iterations; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		LoadResult result = loadSkeletonData(loader, path, content);
+		auto end = std::chrono::steady_clock::now();
+		delete result.skeletonData;
+		timings.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	std::sort(timings.begin(), timings.end());
+	double mean = 0.0;
+	for (double timing : timings) {
+		mean += timing;
+	}
+	mean /= timings.size();
+
+	std::cout << "[OK] " << path.string()
+			  << " size_kb=" << content.size() / 1024
+			  << " load_ms_min=" << timings.front()
+			  << " load_ms_median=" << timings[timings.size() / 2]
+			  << " load_ms_mean=" << mean
+			  << " allocations=" << allocations
+			  << " retained_kb=" << retainedBytes / 1024.0
+			  << " bones=" << retained.skeletonData->getBones().size()
+			  << " animations=" << retained.skeletonData->getAnimations().size()
+			  << std::endl;
+	delete retained.skeletonData;
+	return true;
+}
+
+struct SampleStats {
+	size_t frames = 0;
+	double totalNs = 0.0;
+	std::vector<double> frameNs;
+};
+
+void updateWorldTransform(spine::Skeleton& skeleton) {
+#if SPINE_RUNTIME_VERSION >= 42
+	skeleton.updateWorldTransform(spine::Physics_Update);
+#else
+	skeleton.updateWorldTransform();
+#endif
+}
+
+// Plays one animation from the setup pose at a fixed step, timing only AnimationState::apply and
+// Skeleton::updateWorldTransform. Advancing the state (and physics time on 4.2) is excluded.
+void sampleAnimation(spine::Skeleton& skeleton, spine::AnimationState& state, spine::Animation* animation, float fps, int loops, SampleStats& stats) {
+	const float step = 1.0f / fps;
+	const size_t framesPerLoop = static_cast<size_t>(std::max(1.0f, std::ceil(animation->getDuration() * fps)));
+	for (int loop = 0; loop < loops; ++loop) {
+		skeleton.setToSetupPose();
+		state.clearTracks();
+		state.setAnimation(0, animation, false);
+		state.update(0.0f);
+		for (size_t frame = 0; frame <= framesPerLoop; ++frame) {
+			auto start = std::chrono::steady_clock::now();
+			state.apply(skeleton);
+			updateWorldTransform(skeleton);
+			auto end = std::chrono::steady_clock::now();
+			double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			stats.frames++;
+			stats.totalNs += ns;
+			stats.frameNs.push_back(ns);
+			state.update(step);
+#if SPINE_RUNTIME_VERSION >= 42
+			skeleton.update(step);
+#endif
+		}
+	}
+}
+
+double median(std::vector<double>& values) {
+	if (values.empty()) {
+		return 0.0;
+	}
+	std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+	return values[values.size() / 2];
+}
+
+bool benchmarkAnimate(const fs::path& path, float fps, int loops, bool verbose) {
+	std::vector<char> content;
+	if (!readFile(path, content)) {
+		std::cout << "[FAIL] " << path.string() << ": cannot read file" << std::endl;
+		return false;
+	}
+
+	RegionlessAttachmentLoader loader;
+	LoadResult loaded = loadSkeletonData(loader, path, content);
+	if (!loaded.error.empty()) {
+		delete loaded.skeletonData;
+		std::cout << "[FAIL] " << path.string() << ": " << loaded.error << std::endl;
+		return false;
+	}
+
+	{
+		spine::Skeleton skeleton(loaded.skeletonData);
+		spine::AnimationStateData stateData(loaded.skeletonData);
+		spine::AnimationState state(&stateData);
+
+		SampleStats total;
+		std::ostringstream details;
+		auto& animations = loaded.skeletonData->getAnimations();
+		for (size_t i = 0; i < animations.size(); ++i) {
+			SampleStats stats;
+			sampleAnimation(skeleton, state, animations[i], fps, loops, stats);
+			if (verbose) {
+				details << "  " << animations[i]->getName().buffer()
+						<< " frames=" << stats.frames
+						<< " ns_per_frame_mean=" << stats.totalNs / std::max<size_t>(1, stats.frames)
+						<< " ns_per_frame_median=" << median(stats.frameNs) << std::endl;
+			}
+			total.frames += stats.frames;
+			total.totalNs += stats.totalNs;
+			total.frameNs.insert(total.frameNs.end(), stats.frameNs.begin(), stats.frameNs.end());
+		}
+
+		std::cout << "[OK] " << path.string()
+				  << " animations=" << animations.size()
+				  << " frames=" << total.frames
+				  << " ns_per_frame_mean=" << total.totalNs / std::max<size_t>(1, total.frames)
+				  << " ns_per_frame_median=" << median(total.frameNs)
+				  << std::endl;
+		std::cout << details.str();
+	}
+	delete loaded.skeletonData;
+	return true;
+}
+
+void printUsage(const char* programName) {
+	std::cout << "Usage: " << programName << " load [--iterations N] <skeleton_file>..." << std::endl;
+	std::cout << "       " << programName << " animate [--fps N] [--loops N] [--verbose] <skeleton_file>..." << std::endl;
+	std::cout << "Loads each .json/.skel file with the spine-cpp " << SPINE_RUNTIME_VERSION / 10 << "." << SPINE_RUNTIME_VERSION % 10 << " runtime." << std::endl;
+	std::cout << "  load     Reports load time, the allocations of one load and the memory the loaded skeleton keeps." << std::endl;
+	std::cout << "  animate  Plays every animation through AnimationState at a fixed step (default 60 fps, 10 loops)" << std::endl;
+	std::cout << "           and reports ns per AnimationState::apply + Skeleton::updateWorldTransform." << std::endl;
+	std::cout << "Exits with 1 if any file fails to load." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::string mode = argc >= 2 ? argv[1] : "";
+	if (argc < 3 || (mode != "load" && mode != "animate")) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	int iterations = 20;
+	float fps = 60.0f;
+	int loops = 10;
+	bool verbose = false;
+	std::vector<fs::path> files;
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		if ((arg == "--iterations" || arg == "-n") && i + 1 < argc) {
+			iterations = std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "--fps" && i + 1 < argc) {
+			fps = std::max(1.0f, static_cast<float>(std::atof(argv[++i])));
+		} else if (arg == "--loops" && i + 1 < argc) {
+			loops = std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "--verbose" || arg == "-v") {
+			verbose = true;
+		} else {
+			files.emplace_back(arg);
+		}
+	}
+
+	bool success = true;
+	for (const auto& file : files) {
+		if (mode == "load") {
+			success = benchmarkLoad(file, iterations) && success;
+		} else {
+			success = benchmarkAnimate(file, fps, loops, verbose) && success;
+		}
+	}
+	return success ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+#include "SkeletonData.h"
+#include <regex>
+
+namespace {
+
+bool aboveOrEqualVersion(SpineVersion version, SpineVersion target) {
+    return static_cast<int>(version) >= static_cast<int>(target);
+}
+
+bool belowOrEqualVersion(SpineVersion version, SpineVersion target) {
+    return static_cast<int>(version) <= static_cast<int>(target);
+}
+
+Binary textBytes(const std::string& text) {
+    return Binary(text.begin(), text.end());
+}
+
+// The 4.2 binary writer stores the hull length implied by the triangle count, which Spine's own tools
+// expect (issue #4); reports the meshes where that differs from the stored one.
+void warnHullLengthMismatches(const SkeletonData& skeleton, std::ostream& warnings) {
+    for (const auto& skin : skeleton.skins) {
+        for (const auto& [slotName, attachments] : skin.attachments) {
+            for (const auto& [attachmentName, attachment] : attachments) {
+                const MeshAttachment* mesh = std::get_if<MeshAttachment>(&attachment.data);
+                if (attachment.type != AttachmentType_Mesh || !mesh) continue;
+                int actualHullLength = mesh->uvs.size() - mesh->triangles.size() / 3 - 2;
+                if (actualHullLength == mesh->hullLength) continue;
+                warnings << "Warning: Mismatch hullLength for mesh attachment '" << attachment.name << "'. Expected: "
+                         << mesh->hullLength << ", Actual: " << actualHullLength << "\n";
+                warnings << "Actual hullLength will be written to the binary file.\n";
+            }
+        }
+    }
+}
+
+}
+
+std::string getVersionString(SpineVersion version) {
+    switch (version) {
+        case SpineVersion::Version35: return "3.5";
+        case SpineVersion::Version36: return "3.6";
+        case SpineVersion::Version37: return "3.7";
+        case SpineVersion::Version38: return "3.8";
+        case SpineVersion::Version40: return "4.0";
+        case SpineVersion::Version41: return "4.1";
+        case SpineVersion::Version42: return "4.2";
+        default: return "Unknown";
+    }
+}
+
+SpineVersion parseVersionString(const std::string& versionStr) {
+    // 强制要求完整的三段式版本号 (x.y.z)
+    std::regex versionRegex(R"(^(\d+)\.(\d+)\.(\d+)$)");
+    std::smatch match;
+    
+    if (std::regex_match(versionStr, match, versionRegex)) {
+        std::string majorVersion = match[1].str();
+        std::string minorVersion = match[2].str();
+        std::string majorMinor = majorVersion + "." + minorVersion;
+        
+        if (majorMinor == "3.5") return SpineVersion::Version35;
+        else if (majorMinor == "3.6") return SpineVersion::Version36;
+        else if (majorMinor == "3.7") return SpineVersion::Version37;
+        else if (majorMinor == "3.8") return SpineVersion::Version38;
+        else if (majorMinor == "4.0") return SpineVersion::Version40;
+        else if (majorMinor == "4.1") return SpineVersion::Version41;
+        else if (majorMinor == "4.2") return SpineVersion::Version42;
+    }
+    
+    return SpineVersion::Invalid;
+}
+
+ConversionResult convertSkeleton(Binary input, const ConversionSettings& settings, std::ostream& log, std::ostream& warnings) {
+    FileFormat inputFormat = settings.inputFormat != FileFormat::Unknown ? settings.inputFormat : detectFileFormat(input.data(), input.size());
+    FileFormat outputFormat = settings.outputFormat != FileFormat::Unknown ? settings.outputFormat : inputFormat;
+    if (inputFormat == FileFormat::Unknown) throw std::runtime_error("Empty input");
+
+    // Detect input Spine version
+    SpineVersion inputVersion = detectSpineVersion(input.data(), input.size());
+    if (inputVersion == SpineVersion::Invalid) throw std::runtime_error("Could not detect Spine version from input file");
+
+    // Use output version if specified, otherwise use input version
+    SpineVersion outputVersion = (settings.outputVersion != SpineVersion::Invalid) ? settings.outputVersion : inputVersion;
+    const std::string& outputVersionString = settings.outputVersionString; // 使用用户指定的完整版本号
+
+    log << "Detected input Spine version: " << getVersionString(inputVersion) << "\n";
+    if (inputVersion != outputVersion) {
+        log << "Converting to output Spine version: " << getVersionString(outputVersion);
+        if (!outputVersionString.empty()) {
+            log << " (" << outputVersionString << ")";
+        }
+        log << "\n";
+    }
+    if (settings.removeCurve) {
+        log << "Option --remove-curve enabled: curves will be stripped instead of converted when crossing 3.x/4.x.\n";
+    }
+    log << "Converting from " << (inputFormat == FileFormat::Json ? "JSON" : "SKEL")
+        << " to " << (outputFormat == FileFormat::Json ? "JSON" : "SKEL") << "...\n";
+
+    // Read data using input version
+    SkeletonData skelData = readSkeletonData(std::move(input), inputFormat, inputVersion, settings.animations, log);
+    
+    if (!settings.animations.empty() || !settings.skins.empty()) {
+        log << "Extracting requested animations and skins...\n";
+        SubsetStats stats = subsetSkeleton(skelData, settings.animations, settings.skins);
+        for (const auto& name : stats.unknownNames) {
+            warnings << "Warning: No animation or skin named '" << name << "'\n";
+        }
+        log << "Removed " << stats.removedAnimations << " animations, " << stats.removedSkins << " skins, "
+            << stats.removedBones << " bones, " << stats.removedSlots << " slots, "
+            << stats.removedConstraints << " constraints, " << stats.removedEvents << " events\n";
+    }
+
+    // 如果指定了输出版本字符串，则设置版本号
+    if (!outputVersionString.empty()) {
+        skelData.version = outputVersionString;
+    }
+    
+    // 跨版本转换处理
+    if (aboveOrEqualVersion(inputVersion, SpineVersion::Version40) &&
+        belowOrEqualVersion(outputVersion, SpineVersion::Version38)) {
+        log << "Converting 4.x proportional path spacing mode to length for 3.x...\n";
+        convertSpacingMode4xTo3x(skelData);
+        log << "Converting Spine 4.x rotate timelines to 3.x-compatible shortest-path keys...\n";
+        convertRotateTimeline4xTo3x(skelData);
+        if (settings.removeCurve) {
+            log << "Converting from 4.x to 3.x with --remove-curve, stripping curves...\n";
+            removeCurve(skelData);
+        } else {
+            log << "Converting from 4.x to 3.x, adjusting curve format from abs to rel...\n"; 
+            convertCurve4xTo3x(skelData);
+        }
+    }
+    if (belowOrEqualVersion(inputVersion, SpineVersion::Version38) &&
+        aboveOrEqualVersion(outputVersion, SpineVersion::Version40)) {
+        log << "Converting Spine 3.x rotate timelines to 4.x-compatible absolute angles...\n";
+        convertRotateTimeline3xTo4x(skelData);
+        if (settings.removeCurve) {
+            log << "Converting from 3.x to 4.x with --remove-curve, stripping curves...\n";
+            removeCurve(skelData);
+        } else {
+            log << "Converting from 3.x to 4.x, adjusting curve format from rel to abs...\n"; 
+            convertCurve3xTo4x(skelData);
+        }
+    }
+    if (aboveOrEqualVersion(inputVersion, SpineVersion::Version42) &&
+        belowOrEqualVersion(outputVersion, SpineVersion::Version41)) {
+        log << "Converting from 4.2 to below 4.2, adjusting constraint order...\n"; 
+        convertOrder42ToBelow(skelData);
+    }
+
+    // 以下处理在跨版本转换之后进行，曲线已是输出版本的格式
+    if (settings.scale) {
+        log << "Scaling skeleton by " << *settings.scale << "...\n";
+        scaleSkeleton(skelData, *settings.scale);
+    }
+    if (settings.bakeCurvesFps) {
+        log << "Baking bezier curves into linear keys at " << *settings.bakeCurvesFps << " fps...\n";
+        size_t inserted = bakeCurves(skelData, *settings.bakeCurvesFps);
+        log << "Inserted " << inserted << " sampled keys\n";
+    }
+    if (settings.reduceKeysTolerance) {
+        log << "Reducing keyframes with tolerance " << *settings.reduceKeysTolerance << "...\n";
+        size_t removed = reduceKeyframes(skelData, *settings.reduceKeysTolerance);
+        log << "Removed " << removed << " redundant keys\n";
+    }
+    if (settings.maxInfluences) {
+        log << "Limiting weighted vertices to " << *settings.maxInfluences << " bone influences...\n";
+        InfluenceLimitStats stats = limitBoneInfluences(skelData, *settings.maxInfluences);
+        log << "Removed " << stats.removedInfluences << " influences from " << stats.vertices << " vertices, max position error " << stats.maxError << "\n";
+    }
+    if (settings.optimizeTriangles || settings.reorderVertices) {
+        log << "Reordering mesh triangles" << (settings.reorderVertices ? " and vertices" : "") << " for vertex cache locality...\n";
+        MeshOptimizeStats stats = optimizeMeshes(skelData, settings.reorderVertices);
+        if (stats.triangles > 0) {
+            log << "Reordered " << stats.meshes << " meshes, cache misses per triangle "
+                << static_cast<float>(stats.missesBefore) / stats.triangles << " -> "
+                << static_cast<float>(stats.missesAfter) / stats.triangles << "\n";
+        }
+    }
+    if (settings.optimizeDeform) {
+        log << "Optimizing deform timelines...\n";
+        DeformOptimizeStats stats = optimizeDeformTimelines(skelData);
+        log << "Trimmed " << stats.trimmedValues << " zero vertex offsets, removed " << stats.removedFrames << " repeated frames\n";
+    }
+    if (!constraintOrdersDense(skelData, aboveOrEqualVersion(outputVersion, SpineVersion::Version42))) {
+        warnings << "Warning: Constraint orders are not 0..n-1, runtimes will not update the constraints past the gaps\n";
+    }
+    
+    // Write data using output version
+    if (outputFormat == FileFormat::Skel && outputVersion == SpineVersion::Version42) {
+        warnHullLengthMismatches(skelData, warnings);
+    }
+    std::vector<AnimationRange> animationRanges;
+    Binary outputData;
+    Json outputJson;
+    auto serialize = [&]() {
+        animationRanges.clear();
+        if (outputFormat == FileFormat::Skel) outputData = writeBinaryData(skelData, outputVersion, &animationRanges);
+        else outputJson = writeJsonData(skelData, outputVersion);
+    };
+    // Shards reference the base by hash: 4.x files only store the 64-bit one, and a skeleton without
+    // any gets a hash of its content.
+    if (settings.split && aboveOrEqualVersion(outputVersion, SpineVersion::Version40)) skelData.hashString.reset();
+    if (settings.split && !skelData.hashString && skelData.hash == 0) {
+        serialize();
+        std::string content = outputFormat == FileFormat::Skel ? std::string(outputData.begin(), outputData.end()) : dumpJson(outputJson);
+        skelData.hash = hashBytes(content.data(), content.size());
+    }
+    serialize();
+
+    ConversionResult result;
+    if (settings.split) {
+        if (settings.writeIndex) {
+            warnings << "Warning: --index is not written with --split, shards already hold one animation group each\n";
+        }
+        std::vector<AnimationGroup> groups = groupAnimations(skelData, settings.groups);
+        if (outputFormat == FileFormat::Skel) {
+            BinarySplit split = splitBinary(outputData, animationRanges, skeletonHashString(skelData), groups);
+            result.output = std::move(split.base);
+            result.shards = std::move(split.shards);
+        } else {
+            JsonSplit split = splitJson(outputJson, groups);
+            result.output = textBytes(dumpJson(split.base));
+            for (const auto& [name, shard] : split.shards) result.shards.emplace_back(name, textBytes(dumpJson(shard)));
+        }
+        log << "Split " << skelData.animations.size() << " animations into " << result.shards.size()
+            << " shards of skeleton " << skeletonHashString(skelData) << "\n";
+        return result;
+    }
+    result.output = outputFormat == FileFormat::Skel ? std::move(outputData) : textBytes(dumpJson(outputJson));
+
+    if (settings.writeIndex) {
+        if (outputFormat != FileFormat::Skel) {
+            warnings << "Warning: --index only applies to .skel output\n";
+        } else {
+            result.index = dumpJson(buildAnimationIndex(skelData, animationRanges));
+        }
+    }
+    return result;
+}
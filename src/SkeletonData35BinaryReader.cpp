@@ -1,4 +1,5 @@
 #include "SkeletonData.h"
+#include <algorithm>
 
 namespace spine35 {
 
@@ -395,7 +396,93 @@ Animation readAnimation(DataInput* input, SkeletonData* skeletonData) {
     return animation; 
 }
 
-SkeletonData readBinaryData(const Binary& binary) {
+// Walks an animation like readAnimation without building timelines. Frames of curve timelines have a
+// fixed size, so only the curve types are read.
+void skipAnimation(DataInput* input, SkeletonData* skeletonData, AnimationRange& range) {
+    range.name = readString(input).value();
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            int timelineType = static_cast<int>(readByte(input));
+            int frameCount = readVarint(input, true);
+            switch (timelineType) {
+                case 0: {  // SLOT_ATTACHMENT
+                    for (int frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+                        skipBytes(input, 4);
+                        skipString(input);
+                    }
+                    break; 
+                }
+                case 1: skipCurveTimeline3x(input, frameCount, 8); break;    // SLOT_COLOR
+                case 2: skipCurveTimeline3x(input, frameCount, 12); break;   // SLOT_TWO_COLOR
+            }
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            int timelineType = static_cast<int>(readByte(input));
+            int frameCount = readVarint(input, true);
+            if (timelineType >= 0 && timelineType <= 3) skipCurveTimeline3x(input, frameCount, timelineType == 0 ? 8 : 12);
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        skipCurveTimeline3x(input, readVarint(input, true), 9);
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        skipCurveTimeline3x(input, readVarint(input, true), 20);
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            PathTimelineType timelineType = static_cast<PathTimelineType>(readByte(input));
+            int frameCount = readVarint(input, true);
+            if (timelineType >= PATH_POSITION && timelineType <= PATH_MIX) skipCurveTimeline3x(input, frameCount, timelineType == PATH_MIX ? 12 : 8);
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            readVarint(input, true);
+            for (int iii = 0, nnn = readVarint(input, true); iii < nnn; iii++) {
+                skipString(input);
+                int frameCount = readVarint(input, true);
+                for (int frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+                    skipBytes(input, 4);
+                    size_t end = (size_t) readVarint(input, true);
+                    if (end != 0) {
+                        readVarint(input, true);
+                        skipBytes(input, end * 4);
+                    }
+                    if (frameIndex < frameCount - 1 && readByte(input) == CURVE_BEZIER) skipBytes(input, 16);
+                }
+            }
+        }
+    }
+    size_t drawOrderCount = (size_t) readVarint(input, true);
+    for (size_t i = 0; i < drawOrderCount; i++) {
+        skipBytes(input, 4);
+        size_t offsetCount = (size_t) readVarint(input, true);
+        for (size_t ii = 0; ii < offsetCount; ii++) {
+            readVarint(input, true);
+            readVarint(input, true);
+        }
+    }
+    int eventCount = readVarint(input, true);
+    for (int i = 0; i < eventCount; i++) {
+        skipBytes(input, 4);
+        const EventData& eventData = skeletonData->events[readVarint(input, true)];
+        if (std::find(range.events.begin(), range.events.end(), eventData.name) == range.events.end())
+            range.events.push_back(eventData.name);
+        readVarint(input, false);
+        skipBytes(input, 4);
+        if (readBoolean(input)) skipString(input);
+    }
+}
+
+SkeletonData readSkeleton(const Binary& binary, std::vector<AnimationRange>* animationRanges) {
     SkeletonData skeletonData;
     DataInput input; 
     input.cursor = binary.data(); 
@@ -542,6 +629,14 @@ SkeletonData readBinaryData(const Binary& binary) {
     /* Animations */
     int animationCount = readVarint(&input, true);
     for (int i = 0; i < animationCount; i++) {
+        if (animationRanges) {
+            AnimationRange range; 
+            range.offset = input.cursor - binary.data(); 
+            skipAnimation(&input, &skeletonData, range);
+            range.size = input.cursor - binary.data() - range.offset; 
+            animationRanges->push_back(range);
+            continue; 
+        }
         Animation animation = readAnimation(&input, &skeletonData);
         skeletonData.animations.push_back(animation);
     }
@@ -549,4 +644,16 @@ SkeletonData readBinaryData(const Binary& binary) {
     return skeletonData;
 }
 
+SkeletonData readBinaryData(const Binary& binary) {
+    return readSkeleton(binary, nullptr);
+}
+
+LazySkeletonData readBinaryDataLazy(Binary binary) {
+    LazySkeletonData lazy; 
+    lazy.skeleton = readSkeleton(binary, &lazy.animationRanges);
+    lazy.binary = std::move(binary);
+    lazy.readAnimation = readAnimation;
+    return lazy;
+}
+
 }
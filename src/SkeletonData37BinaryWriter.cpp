@@ -474,7 +474,7 @@ void writeAnimation(Binary& binary, const Animation& animation, const SkeletonDa
     }
 }
 
-Binary writeBinaryData(SkeletonData& skeletonData) {
+Binary writeBinaryData(SkeletonData& skeletonData, std::vector<AnimationRange>* animationRanges) {
     Binary binary;
     
     if (skeletonData.hashString) {
@@ -682,7 +682,15 @@ Binary writeBinaryData(SkeletonData& skeletonData) {
     /* Animations */
     writeVarint(binary, skeletonData.animations.size(), true);
     for (const Animation& animation : skeletonData.animations) {
+        size_t offset = binary.size();
         writeAnimation(binary, animation, skeletonData);
+        if (animationRanges) {
+            AnimationRange range;
+            range.name = animation.name;
+            range.offset = offset;
+            range.size = binary.size() - offset;
+            animationRanges->push_back(range);
+        }
     }
 
     return binary;
@@ -1,4 +1,5 @@
 #include "SkeletonData.h"
+#include <algorithm>
 
 namespace spine40 {
 
@@ -642,7 +643,110 @@ Animation readAnimation(DataInput* input, SkeletonData* skeletonData) {
     return animation; 
 }
 
-SkeletonData readBinaryData(const Binary& binary) {
+// Walks an animation like readAnimation without building timelines. Curve timelines are skipped
+// from their frame sizes, reading only the curve types; the rest frame by frame.
+void skipAnimation(DataInput* input, SkeletonData* skeletonData, AnimationRange& range) {
+    range.name = readString(input).value();
+    readVarint(input, true);
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            SlotTimelineType timelineType = static_cast<SlotTimelineType>(readByte(input));
+            int frameCount = readVarint(input, true);
+            switch (timelineType) {
+                case SlotTimelineType::SLOT_ATTACHMENT: {
+                    for (int frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+                        skipBytes(input, 4);
+                        readVarint(input, true);
+                    }
+                    break; 
+                }
+                case SlotTimelineType::SLOT_RGBA: skipCurveTimeline4x(input, frameCount, 8, 4); break; 
+                case SlotTimelineType::SLOT_RGB: skipCurveTimeline4x(input, frameCount, 7, 3); break; 
+                case SlotTimelineType::SLOT_RGBA2: skipCurveTimeline4x(input, frameCount, 11, 7); break; 
+                case SlotTimelineType::SLOT_RGB2: skipCurveTimeline4x(input, frameCount, 10, 6); break; 
+                case SlotTimelineType::SLOT_ALPHA: skipCurveTimeline4x(input, frameCount, 5, 1); break; 
+            }
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            BoneTimelineType timelineType = static_cast<BoneTimelineType>(readByte(input));
+            int frameCount = readVarint(input, true);
+            bool twoValues = timelineType == BONE_TRANSLATE || timelineType == BONE_SCALE || timelineType == BONE_SHEAR;
+            skipCurveTimeline4x(input, frameCount, twoValues ? 12 : 8, twoValues ? 2 : 1);
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        int frameCount = readVarint(input, true);
+        readVarint(input, true);
+        skipBytes(input, 15);
+        for (int frameIndex = 1; frameIndex < frameCount; frameIndex++) {
+            skipBytes(input, 12);
+            if (readSByte(input) == CURVE_BEZIER) skipBytes(input, 32);
+            skipBytes(input, 3);
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        int frameCount = readVarint(input, true);
+        skipCurveTimeline4x(input, frameCount, 28, 6);
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            PathTimelineType timelineType = static_cast<PathTimelineType>(readByte(input));
+            int frameCount = readVarint(input, true);
+            skipCurveTimeline4x(input, frameCount, timelineType == PATH_MIX ? 16 : 8, timelineType == PATH_MIX ? 3 : 1);
+        }
+    }
+    for (int i = 0, n = readVarint(input, true); i < n; i++) {
+        readVarint(input, true);
+        for (int ii = 0, nn = readVarint(input, true); ii < nn; ii++) {
+            readVarint(input, true);
+            for (int iii = 0, nnn = readVarint(input, true); iii < nnn; iii++) {
+                readVarint(input, true);
+                int frameCount = readVarint(input, true);
+                readVarint(input, true);
+                skipBytes(input, 4);
+                for (int frameIndex = 0; ; frameIndex++) {
+                    size_t end = (size_t) readVarint(input, true);
+                    if (end != 0) {
+                        readVarint(input, true);
+                        skipBytes(input, end * 4);
+                    }
+                    if (frameIndex == frameCount - 1) break; 
+                    skipBytes(input, 4);
+                    if (readSByte(input) == CURVE_BEZIER) skipBytes(input, 16);
+                }
+            }
+        }
+    }
+    size_t drawOrderCount = (size_t) readVarint(input, true);
+    for (size_t i = 0; i < drawOrderCount; i++) {
+        skipBytes(input, 4);
+        size_t offsetCount = (size_t) readVarint(input, true);
+        for (size_t ii = 0; ii < offsetCount; ii++) {
+            readVarint(input, true);
+            readVarint(input, true);
+        }
+    }
+    int eventCount = readVarint(input, true);
+    for (int i = 0; i < eventCount; i++) {
+        skipBytes(input, 4);
+        const EventData& eventData = skeletonData->events[readVarint(input, true)];
+        if (std::find(range.events.begin(), range.events.end(), eventData.name) == range.events.end())
+            range.events.push_back(eventData.name);
+        readVarint(input, false);
+        skipBytes(input, 4);
+        if (readBoolean(input)) skipString(input);
+        if (eventData.audioPath && !eventData.audioPath->empty()) skipBytes(input, 8);
+    }
+}
+
+SkeletonData readSkeleton(const Binary& binary, std::vector<AnimationRange>* animationRanges) {
     SkeletonData skeletonData;
     DataInput input; 
     input.cursor = binary.data(); 
@@ -810,6 +914,14 @@ SkeletonData readBinaryData(const Binary& binary) {
     /* Animations */
     int animationCount = readVarint(&input, true);
     for (int i = 0; i < animationCount; i++) {
+        if (animationRanges) {
+            AnimationRange range; 
+            range.offset = input.cursor - binary.data(); 
+            skipAnimation(&input, &skeletonData, range);
+            range.size = input.cursor - binary.data() - range.offset; 
+            animationRanges->push_back(range);
+            continue; 
+        }
         Animation animation = readAnimation(&input, &skeletonData);
         skeletonData.animations.push_back(animation);
     }
@@ -817,4 +929,16 @@ SkeletonData readBinaryData(const Binary& binary) {
     return skeletonData;
 }
 
+SkeletonData readBinaryData(const Binary& binary) {
+    return readSkeleton(binary, nullptr);
+}
+
+LazySkeletonData readBinaryDataLazy(Binary binary) {
+    LazySkeletonData lazy; 
+    lazy.skeleton = readSkeleton(binary, &lazy.animationRanges);
+    lazy.binary = std::move(binary);
+    lazy.readAnimation = readAnimation;
+    return lazy;
+}
+
 }
@@ -236,11 +236,8 @@ void writeSkin(Binary& binary, const Skin& skin, const SkeletonData& skeletonDat
                     // 为了让 Spine 官方工具能正确读取，这里写入计算得到的 hullLength
                     // writeVarint(binary, mesh.hullLength, true);
                     int actualHullLength = mesh.uvs.size() - mesh.triangles.size() / 3 - 2; 
+                    // convertSkeleton warns when this differs from mesh.hullLength.
                     writeVarint(binary, actualHullLength, true);
-                    if (actualHullLength != mesh.hullLength) {
-                        std::cout << "Warning: Mismatch hullLength for mesh attachment '" << attachment.name << "'. Expected: " << mesh.hullLength << ", Actual: " << actualHullLength << std::endl;
-                        std::cout << "Actual hullLength will be written to the binary file." << std::endl;
-                    }
                     
                     writeVertices(binary, mesh.vertices, (flags & 128) != 0);
                     writeFloatArray(binary, mesh.uvs);
@@ -710,7 +707,7 @@ void writeAnimation(Binary& binary, const Animation& animation, const SkeletonDa
     }
 }
 
-Binary writeBinaryData(SkeletonData& skeletonData) {
+Binary writeBinaryData(SkeletonData& skeletonData, std::vector<AnimationRange>* animationRanges) {
     Binary binary;
     
     writeInt(binary, skeletonData.hash & 0xffffffff); 
@@ -1041,7 +1038,15 @@ Binary writeBinaryData(SkeletonData& skeletonData) {
     /* Animations */
     writeVarint(binary, skeletonData.animations.size(), true);
     for (const Animation& animation : skeletonData.animations) {
+        size_t offset = binary.size();
         writeAnimation(binary, animation, skeletonData);
+        if (animationRanges) {
+            AnimationRange range;
+            range.name = animation.name;
+            range.offset = offset;
+            range.size = binary.size() - offset;
+            animationRanges->push_back(range);
+        }
     }
 
     return binary;
@@ -0,0 +1,481 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+
+namespace {
+
+std::string formatFloat(double value) {
+    std::ostringstream oss;
+    oss << value;
+    return oss.str();
+}
+
+std::string formatOptStr(const OptStr& str) {
+    return str ? "\"" + *str + "\"" : "null";
+}
+
+std::string formatOptColor(const OptColor& color) {
+    return color ? colorToString(*color, true) : "null";
+}
+
+class SkeletonDiffer {
+public:
+    SkeletonDiffer(const DiffTolerance& tolerance, std::vector<SkeletonDiff>& diffs)
+        : tolerance(tolerance), diffs(diffs) {}
+
+    // Same rule as tools/json_diff.py: values both close to zero are equal, a zero side
+    // falls back to an absolute comparison, everything else is compared relatively.
+    void relative(const std::string& path, double a, double b, double tol) {
+        if (a == b) return;
+        if (std::fabs(a) < 0.001 && std::fabs(b) < 0.001) return;
+        double difference = std::fabs(a - b);
+        double largest = std::max(std::fabs(a), std::fabs(b));
+        if (a == 0.0 || b == 0.0) {
+            if (difference <= tol) return;
+        } else if (difference / largest <= tol) {
+            return;
+        }
+        addNumber(path, a, b, difference, largest != 0.0 ? difference / largest : difference, tol);
+    }
+
+    void absolute(const std::string& path, double a, double b, double tol) {
+        double difference = std::fabs(a - b);
+        if (difference <= tol) return;
+        double largest = std::max(std::fabs(a), std::fabs(b));
+        addNumber(path, a, b, difference, largest != 0.0 ? difference / largest : difference, tol);
+    }
+
+    void value(const std::string& path, double a, double b) { relative(path, a, b, tolerance.value); }
+    void time(const std::string& path, double a, double b) { absolute(path, a, b, tolerance.time); }
+    void angle(const std::string& path, double a, double b) { absolute(path, a, b, tolerance.angle); }
+
+    template <typename T>
+    void equal(const std::string& path, const T& a, const T& b) {
+        if (a == b) return;
+        add(path, DiffType::Diff_Value, toString(a), toString(b));
+    }
+
+    void color(const std::string& path, const Color& a, const Color& b) {
+        if (std::abs(a.r - b.r) <= tolerance.color && std::abs(a.g - b.g) <= tolerance.color &&
+            std::abs(a.b - b.b) <= tolerance.color && std::abs(a.a - b.a) <= tolerance.color) return;
+        add(path, DiffType::Diff_Value, colorToString(a, true), colorToString(b, true));
+    }
+
+    void color(const std::string& path, const OptColor& a, const OptColor& b) {
+        if (a && b) color(path, *a, *b);
+        else if (a.has_value() != b.has_value()) add(path, DiffType::Diff_Value, formatOptColor(a), formatOptColor(b));
+    }
+
+    void floats(const std::string& path, const std::vector<float>& a, const std::vector<float>& b, double tol) {
+        if (!length(path, a.size(), b.size())) return;
+        for (size_t i = 0; i < a.size(); i++)
+            relative(path + "[" + std::to_string(i) + "]", a[i], b[i], tol);
+    }
+
+    void floats(const std::string& path, const std::vector<float>& a, const std::vector<float>& b) {
+        floats(path, a, b, tolerance.value);
+    }
+
+    template <typename T>
+    void list(const std::string& path, const std::vector<T>& a, const std::vector<T>& b) {
+        if (!length(path, a.size(), b.size())) return;
+        for (size_t i = 0; i < a.size(); i++)
+            equal(path + "[" + std::to_string(i) + "]", a[i], b[i]);
+    }
+
+    bool length(const std::string& path, size_t a, size_t b) {
+        if (a == b) return true;
+        add(path, DiffType::Diff_Length, std::to_string(a), std::to_string(b));
+        return false;
+    }
+
+    template <typename Map, typename Compare>
+    void map(const std::string& path, const Map& a, const Map& b, Compare compare) {
+        for (const auto& [key, value] : a) {
+            auto it = b.find(key);
+            if (it == b.end()) add(path + "." + key, DiffType::Diff_MissingInSecond, "", "");
+            else compare(path + "." + key, value, it->second);
+        }
+        for (const auto& [key, value] : b) {
+            if (a.find(key) == a.end()) add(path + "." + key, DiffType::Diff_MissingInFirst, "", "");
+        }
+    }
+
+    template <typename T, typename Compare>
+    void array(const std::string& path, const std::vector<T>& a, const std::vector<T>& b, Compare compare) {
+        length(path, a.size(), b.size());
+        size_t n = std::min(a.size(), b.size());
+        for (size_t i = 0; i < n; i++)
+            compare(path + "[" + std::to_string(i) + "]", a[i], b[i]);
+        for (size_t i = n; i < a.size(); i++)
+            add(path + "[" + std::to_string(i) + "]", DiffType::Diff_MissingInSecond, "", "");
+        for (size_t i = n; i < b.size(); i++)
+            add(path + "[" + std::to_string(i) + "]", DiffType::Diff_MissingInFirst, "", "");
+    }
+
+    const DiffTolerance& tolerance;
+
+private:
+    std::vector<SkeletonDiff>& diffs;
+
+    template <typename T>
+    static std::string toString(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) return value ? "true" : "false";
+        else if constexpr (std::is_enum_v<T>) return std::to_string(static_cast<int>(value));
+        else if constexpr (std::is_integral_v<T>) return std::to_string(value);
+        else if constexpr (std::is_same_v<T, std::string>) return "\"" + value + "\"";
+        else if constexpr (std::is_same_v<T, OptStr>) return formatOptStr(value);
+        else return "(" + value.first + ", " + std::to_string(value.second) + ")";
+    }
+
+    void add(const std::string& path, DiffType type, const std::string& value1, const std::string& value2) {
+        SkeletonDiff diff;
+        diff.path = path;
+        diff.type = type;
+        diff.value1 = value1;
+        diff.value2 = value2;
+        diffs.push_back(diff);
+    }
+
+    void addNumber(const std::string& path, double a, double b, double difference, double relativeDifference, double tol) {
+        SkeletonDiff diff;
+        diff.path = path;
+        diff.type = DiffType::Diff_Number;
+        diff.value1 = formatFloat(a);
+        diff.value2 = formatFloat(b);
+        diff.difference = difference;
+        diff.relativeDifference = relativeDifference;
+        diff.tolerance = tol;
+        diffs.push_back(diff);
+    }
+};
+
+bool isAngleTimeline(const std::string& timelineType) {
+    return timelineType == "rotate" || timelineType == "shear" || timelineType == "shearx" || timelineType == "sheary";
+}
+
+void diffFrame(SkeletonDiffer& d, const std::string& path, const TimelineFrame& a, const TimelineFrame& b, bool angle) {
+    d.time(path + ".time", a.time, b.time);
+    d.equal(path + ".str1", a.str1, b.str1);
+    d.equal(path + ".str2", a.str2, b.str2);
+    d.equal(path + ".int1", a.int1, b.int1);
+    const float values1[] = { a.value1, a.value2, a.value3, a.value4, a.value5, a.value6 };
+    const float values2[] = { b.value1, b.value2, b.value3, b.value4, b.value5, b.value6 };
+    for (int i = 0; i < 6; i++) {
+        std::string valuePath = path + ".value" + std::to_string(i + 1);
+        if (angle) d.angle(valuePath, values1[i], values2[i]);
+        else d.value(valuePath, values1[i], values2[i]);
+    }
+    d.color(path + ".color1", a.color1, b.color1);
+    d.color(path + ".color2", a.color2, b.color2);
+    d.equal(path + ".curveType", a.curveType, b.curveType);
+    if (a.curveType == CurveType::CURVE_BEZIER && b.curveType == CurveType::CURVE_BEZIER)
+        d.floats(path + ".curve", a.curve, b.curve, d.tolerance.curve);
+    d.equal(path + ".inherit", a.inherit, b.inherit);
+    d.equal(path + ".sequenceMode", a.sequenceMode, b.sequenceMode);
+    d.equal(path + ".bendPositive", a.bendPositive, b.bendPositive);
+    d.equal(path + ".compress", a.compress, b.compress);
+    d.equal(path + ".stretch", a.stretch, b.stretch);
+    d.floats(path + ".vertices", a.vertices, b.vertices);
+    d.list(path + ".offsets", a.offsets, b.offsets);
+}
+
+void diffTimeline(SkeletonDiffer& d, const std::string& path, const Timeline& a, const Timeline& b, bool angle = false) {
+    d.array(path, a, b, [&](const std::string& p, const TimelineFrame& x, const TimelineFrame& y) {
+        diffFrame(d, p, x, y, angle);
+    });
+}
+
+void diffMultiTimeline(SkeletonDiffer& d, const std::string& path, const MultiTimeline& a, const MultiTimeline& b) {
+    d.map(path, a, b, [&](const std::string& p, const Timeline& x, const Timeline& y) {
+        diffTimeline(d, p, x, y, isAngleTimeline(p.substr(p.rfind('.') + 1)));
+    });
+}
+
+void diffSequence(SkeletonDiffer& d, const std::string& path, const OptSequence& a, const OptSequence& b) {
+    if (a.has_value() != b.has_value()) {
+        d.equal(path, a.has_value(), b.has_value());
+        return;
+    }
+    if (!a) return;
+    d.equal(path + ".count", a->count, b->count);
+    d.equal(path + ".start", a->start, b->start);
+    d.equal(path + ".digits", a->digits, b->digits);
+    d.equal(path + ".setupIndex", a->setupIndex, b->setupIndex);
+}
+
+void diffAttachment(SkeletonDiffer& d, const std::string& path, const Attachment& a, const Attachment& b) {
+    d.equal(path + ".name", a.name, b.name);
+    d.equal(path + ".path", a.path, b.path);
+    d.equal(path + ".type", a.type, b.type);
+    if (a.type != b.type || a.data.index() != b.data.index()) return;
+    switch (a.type) {
+        case AttachmentType_Region: {
+            const auto& x = std::get<RegionAttachment>(a.data);
+            const auto& y = std::get<RegionAttachment>(b.data);
+            d.value(path + ".x", x.x, y.x);
+            d.value(path + ".y", x.y, y.y);
+            d.angle(path + ".rotation", x.rotation, y.rotation);
+            d.value(path + ".scaleX", x.scaleX, y.scaleX);
+            d.value(path + ".scaleY", x.scaleY, y.scaleY);
+            d.value(path + ".width", x.width, y.width);
+            d.value(path + ".height", x.height, y.height);
+            d.color(path + ".color", x.color, y.color);
+            diffSequence(d, path + ".sequence", x.sequence, y.sequence);
+            break;
+        }
+        case AttachmentType_Boundingbox: {
+            const auto& x = std::get<BoundingboxAttachment>(a.data);
+            const auto& y = std::get<BoundingboxAttachment>(b.data);
+            d.equal(path + ".vertexCount", x.vertexCount, y.vertexCount);
+            d.floats(path + ".vertices", x.vertices, y.vertices);
+            d.color(path + ".color", x.color, y.color);
+            break;
+        }
+        case AttachmentType_Mesh: {
+            const auto& x = std::get<MeshAttachment>(a.data);
+            const auto& y = std::get<MeshAttachment>(b.data);
+            d.value(path + ".width", x.width, y.width);
+            d.value(path + ".height", x.height, y.height);
+            d.color(path + ".color", x.color, y.color);
+            diffSequence(d, path + ".sequence", x.sequence, y.sequence);
+            d.equal(path + ".hullLength", x.hullLength, y.hullLength);
+            d.floats(path + ".uvs", x.uvs, y.uvs);
+            d.list(path + ".triangles", x.triangles, y.triangles);
+            d.list(path + ".edges", x.edges, y.edges);
+            d.floats(path + ".vertices", x.vertices, y.vertices);
+            break;
+        }
+        case AttachmentType_Linkedmesh: {
+            const auto& x = std::get<LinkedmeshAttachment>(a.data);
+            const auto& y = std::get<LinkedmeshAttachment>(b.data);
+            d.value(path + ".width", x.width, y.width);
+            d.value(path + ".height", x.height, y.height);
+            d.color(path + ".color", x.color, y.color);
+            diffSequence(d, path + ".sequence", x.sequence, y.sequence);
+            d.equal(path + ".parentMesh", x.parentMesh, y.parentMesh);
+            d.equal(path + ".timelines", x.timelines, y.timelines);
+            d.equal(path + ".skin", x.skin, y.skin);
+            break;
+        }
+        case AttachmentType_Path: {
+            const auto& x = std::get<PathAttachment>(a.data);
+            const auto& y = std::get<PathAttachment>(b.data);
+            d.equal(path + ".vertexCount", x.vertexCount, y.vertexCount);
+            d.floats(path + ".vertices", x.vertices, y.vertices);
+            d.floats(path + ".lengths", x.lengths, y.lengths);
+            d.equal(path + ".closed", x.closed, y.closed);
+            d.equal(path + ".constantSpeed", x.constantSpeed, y.constantSpeed);
+            d.color(path + ".color", x.color, y.color);
+            break;
+        }
+        case AttachmentType_Point: {
+            const auto& x = std::get<PointAttachment>(a.data);
+            const auto& y = std::get<PointAttachment>(b.data);
+            d.value(path + ".x", x.x, y.x);
+            d.value(path + ".y", x.y, y.y);
+            d.angle(path + ".rotation", x.rotation, y.rotation);
+            d.color(path + ".color", x.color, y.color);
+            break;
+        }
+        case AttachmentType_Clipping: {
+            const auto& x = std::get<ClippingAttachment>(a.data);
+            const auto& y = std::get<ClippingAttachment>(b.data);
+            d.equal(path + ".vertexCount", x.vertexCount, y.vertexCount);
+            d.floats(path + ".vertices", x.vertices, y.vertices);
+            d.equal(path + ".endSlot", x.endSlot, y.endSlot);
+            d.color(path + ".color", x.color, y.color);
+            break;
+        }
+    }
+}
+
+void diffAnimation(SkeletonDiffer& d, const std::string& path, const Animation& a, const Animation& b) {
+    d.map(path + ".slots", a.slots, b.slots, [&](const std::string& p, const MultiTimeline& x, const MultiTimeline& y) {
+        diffMultiTimeline(d, p, x, y);
+    });
+    d.map(path + ".bones", a.bones, b.bones, [&](const std::string& p, const MultiTimeline& x, const MultiTimeline& y) {
+        diffMultiTimeline(d, p, x, y);
+    });
+    d.map(path + ".ik", a.ik, b.ik, [&](const std::string& p, const Timeline& x, const Timeline& y) {
+        diffTimeline(d, p, x, y);
+    });
+    d.map(path + ".transform", a.transform, b.transform, [&](const std::string& p, const Timeline& x, const Timeline& y) {
+        diffTimeline(d, p, x, y);
+    });
+    d.map(path + ".path", a.path, b.path, [&](const std::string& p, const MultiTimeline& x, const MultiTimeline& y) {
+        diffMultiTimeline(d, p, x, y);
+    });
+    d.map(path + ".physics", a.physics, b.physics, [&](const std::string& p, const MultiTimeline& x, const MultiTimeline& y) {
+        diffMultiTimeline(d, p, x, y);
+    });
+    d.map(path + ".attachments", a.attachments, b.attachments, [&](const std::string& skinPath, const auto& x, const auto& y) {
+        d.map(skinPath, x, y, [&](const std::string& slotPath, const auto& xs, const auto& ys) {
+            d.map(slotPath, xs, ys, [&](const std::string& p, const MultiTimeline& xt, const MultiTimeline& yt) {
+                diffMultiTimeline(d, p, xt, yt);
+            });
+        });
+    });
+    diffTimeline(d, path + ".drawOrder", a.drawOrder, b.drawOrder);
+    diffTimeline(d, path + ".events", a.events, b.events);
+}
+
+}
+
+std::vector<SkeletonDiff> diffSkeletonData(const SkeletonData& a, const SkeletonData& b, const DiffTolerance& tolerance) {
+    std::vector<SkeletonDiff> diffs;
+    SkeletonDiffer d(tolerance, diffs);
+
+    d.equal("skeleton.hash", a.hash, b.hash);
+    d.equal("skeleton.hashString", a.hashString, b.hashString);
+    d.equal("skeleton.version", a.version, b.version);
+    d.value("skeleton.x", a.x, b.x);
+    d.value("skeleton.y", a.y, b.y);
+    d.value("skeleton.width", a.width, b.width);
+    d.value("skeleton.height", a.height, b.height);
+    d.value("skeleton.referenceScale", a.referenceScale, b.referenceScale);
+    d.equal("skeleton.nonessential", a.nonessential, b.nonessential);
+    if (a.nonessential && b.nonessential) {
+        d.value("skeleton.fps", a.fps, b.fps);
+        d.equal("skeleton.imagesPath", a.imagesPath, b.imagesPath);
+        d.equal("skeleton.audioPath", a.audioPath, b.audioPath);
+    }
+
+    d.array("bones", a.bones, b.bones, [&](const std::string& p, const BoneData& x, const BoneData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".parent", x.parent, y.parent);
+        d.value(p + ".length", x.length, y.length);
+        d.value(p + ".x", x.x, y.x);
+        d.value(p + ".y", x.y, y.y);
+        d.angle(p + ".rotation", x.rotation, y.rotation);
+        d.value(p + ".scaleX", x.scaleX, y.scaleX);
+        d.value(p + ".scaleY", x.scaleY, y.scaleY);
+        d.angle(p + ".shearX", x.shearX, y.shearX);
+        d.angle(p + ".shearY", x.shearY, y.shearY);
+        d.equal(p + ".inherit", x.inherit, y.inherit);
+        d.equal(p + ".skinRequired", x.skinRequired, y.skinRequired);
+        d.color(p + ".color", x.color, y.color);
+        if (a.nonessential && b.nonessential) {
+            d.equal(p + ".icon", x.icon, y.icon);
+            d.equal(p + ".visible", x.visible, y.visible);
+        }
+    });
+
+    d.array("slots", a.slots, b.slots, [&](const std::string& p, const SlotData& x, const SlotData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".bone", x.bone, y.bone);
+        d.color(p + ".color", x.color, y.color);
+        d.color(p + ".darkColor", x.darkColor, y.darkColor);
+        d.equal(p + ".attachmentName", x.attachmentName, y.attachmentName);
+        d.equal(p + ".blendMode", x.blendMode, y.blendMode);
+        if (a.nonessential && b.nonessential) d.equal(p + ".visible", x.visible, y.visible);
+    });
+
+    d.array("ikConstraints", a.ikConstraints, b.ikConstraints, [&](const std::string& p, const IKConstraintData& x, const IKConstraintData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".order", x.order, y.order);
+        d.equal(p + ".skinRequired", x.skinRequired, y.skinRequired);
+        d.list(p + ".bones", x.bones, y.bones);
+        d.equal(p + ".target", x.target, y.target);
+        d.equal(p + ".bendPositive", x.bendPositive, y.bendPositive);
+        d.equal(p + ".compress", x.compress, y.compress);
+        d.equal(p + ".stretch", x.stretch, y.stretch);
+        d.equal(p + ".uniform", x.uniform, y.uniform);
+        d.value(p + ".mix", x.mix, y.mix);
+        d.value(p + ".softness", x.softness, y.softness);
+    });
+
+    d.array("transformConstraints", a.transformConstraints, b.transformConstraints, [&](const std::string& p, const TransformConstraintData& x, const TransformConstraintData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".order", x.order, y.order);
+        d.equal(p + ".skinRequired", x.skinRequired, y.skinRequired);
+        d.list(p + ".bones", x.bones, y.bones);
+        d.equal(p + ".target", x.target, y.target);
+        d.value(p + ".mixRotate", x.mixRotate, y.mixRotate);
+        d.value(p + ".mixX", x.mixX, y.mixX);
+        d.value(p + ".mixY", x.mixY, y.mixY);
+        d.value(p + ".mixScaleX", x.mixScaleX, y.mixScaleX);
+        d.value(p + ".mixScaleY", x.mixScaleY, y.mixScaleY);
+        d.value(p + ".mixShearY", x.mixShearY, y.mixShearY);
+        d.angle(p + ".offsetRotation", x.offsetRotation, y.offsetRotation);
+        d.value(p + ".offsetX", x.offsetX, y.offsetX);
+        d.value(p + ".offsetY", x.offsetY, y.offsetY);
+        d.value(p + ".offsetScaleX", x.offsetScaleX, y.offsetScaleX);
+        d.value(p + ".offsetScaleY", x.offsetScaleY, y.offsetScaleY);
+        d.angle(p + ".offsetShearY", x.offsetShearY, y.offsetShearY);
+        d.equal(p + ".relative", x.relative, y.relative);
+        d.equal(p + ".local", x.local, y.local);
+    });
+
+    d.array("pathConstraints", a.pathConstraints, b.pathConstraints, [&](const std::string& p, const PathConstraintData& x, const PathConstraintData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".order", x.order, y.order);
+        d.equal(p + ".skinRequired", x.skinRequired, y.skinRequired);
+        d.list(p + ".bones", x.bones, y.bones);
+        d.equal(p + ".target", x.target, y.target);
+        d.equal(p + ".positionMode", x.positionMode, y.positionMode);
+        d.equal(p + ".spacingMode", x.spacingMode, y.spacingMode);
+        d.equal(p + ".rotateMode", x.rotateMode, y.rotateMode);
+        d.angle(p + ".offsetRotation", x.offsetRotation, y.offsetRotation);
+        d.value(p + ".position", x.position, y.position);
+        d.value(p + ".spacing", x.spacing, y.spacing);
+        d.value(p + ".mixRotate", x.mixRotate, y.mixRotate);
+        d.value(p + ".mixX", x.mixX, y.mixX);
+        d.value(p + ".mixY", x.mixY, y.mixY);
+    });
+
+    d.array("physicsConstraints", a.physicsConstraints, b.physicsConstraints, [&](const std::string& p, const PhysicsConstraintData& x, const PhysicsConstraintData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".order", x.order, y.order);
+        d.equal(p + ".skinRequired", x.skinRequired, y.skinRequired);
+        d.equal(p + ".bone", x.bone, y.bone);
+        const float values1[] = { x.x, x.y, x.rotate, x.scaleX, x.shearX, x.limit, x.fps, x.inertia, x.strength, x.damping, x.mass, x.wind, x.gravity, x.mix };
+        const float values2[] = { y.x, y.y, y.rotate, y.scaleX, y.shearX, y.limit, y.fps, y.inertia, y.strength, y.damping, y.mass, y.wind, y.gravity, y.mix };
+        const char* names[] = { "x", "y", "rotate", "scaleX", "shearX", "limit", "fps", "inertia", "strength", "damping", "mass", "wind", "gravity", "mix" };
+        for (size_t i = 0; i < std::size(names); i++)
+            d.value(p + "." + names[i], values1[i], values2[i]);
+        const bool globals1[] = { x.inertiaGlobal, x.strengthGlobal, x.dampingGlobal, x.massGlobal, x.windGlobal, x.gravityGlobal, x.mixGlobal };
+        const bool globals2[] = { y.inertiaGlobal, y.strengthGlobal, y.dampingGlobal, y.massGlobal, y.windGlobal, y.gravityGlobal, y.mixGlobal };
+        const char* globalNames[] = { "inertiaGlobal", "strengthGlobal", "dampingGlobal", "massGlobal", "windGlobal", "gravityGlobal", "mixGlobal" };
+        for (size_t i = 0; i < std::size(globalNames); i++)
+            d.equal(p + "." + globalNames[i], globals1[i], globals2[i]);
+    });
+
+    d.array("skins", a.skins, b.skins, [&](const std::string& p, const Skin& x, const Skin& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.list(p + ".bones", x.bones, y.bones);
+        d.list(p + ".ik", x.ik, y.ik);
+        d.list(p + ".transform", x.transform, y.transform);
+        d.list(p + ".path", x.path, y.path);
+        d.list(p + ".physics", x.physics, y.physics);
+        d.color(p + ".color", x.color, y.color);
+        d.map(p + ".attachments", x.attachments, y.attachments, [&](const std::string& slotPath, const auto& xs, const auto& ys) {
+            d.map(slotPath, xs, ys, [&](const std::string& attachmentPath, const Attachment& xa, const Attachment& ya) {
+                diffAttachment(d, attachmentPath, xa, ya);
+            });
+        });
+    });
+
+    d.array("events", a.events, b.events, [&](const std::string& p, const EventData& x, const EventData& y) {
+        d.equal(p + ".name", x.name, y.name);
+        d.equal(p + ".intValue", x.intValue, y.intValue);
+        d.value(p + ".floatValue", x.floatValue, y.floatValue);
+        d.equal(p + ".stringValue", x.stringValue, y.stringValue);
+        d.equal(p + ".audioPath", x.audioPath, y.audioPath);
+        d.value(p + ".volume", x.volume, y.volume);
+        d.value(p + ".balance", x.balance, y.balance);
+    });
+
+    // Animations are keyed by name, like the "animations" object of the JSON format.
+    std::map<std::string, const Animation*> animations1, animations2;
+    for (const auto& animation : a.animations) animations1[animation.name] = &animation;
+    for (const auto& animation : b.animations) animations2[animation.name] = &animation;
+    d.map("animations", animations1, animations2, [&](const std::string& p, const Animation* x, const Animation* y) {
+        diffAnimation(d, p, *x, *y);
+    });
+
+    return diffs;
+}
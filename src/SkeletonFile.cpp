@@ -0,0 +1,194 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+
+namespace {
+
+// Decodes only the requested animations. The others matter to the subset pass only through the events
+// they fire, so they are kept as event-only stubs for it to remove exactly as after a full read.
+SkeletonData readRequestedAnimations(Binary binaryData, SpineVersion inputVersion, const std::vector<std::string>& animations,
+                                     std::ostream& log) {
+    LazySkeletonData lazy = readBinaryDataLazy(std::move(binaryData), inputVersion);
+    size_t decoded = loadAnimations(lazy, animations);
+    log << "Decoded " << decoded << " of " << lazy.animationRanges.size() << " animations\n";
+    for (const auto& range : lazy.animationRanges) {
+        if (std::find(animations.begin(), animations.end(), range.name) != animations.end()) continue;
+        Animation stub;
+        stub.name = range.name;
+        for (const auto& event : range.events) {
+            TimelineFrame frame;
+            frame.str1 = event;
+            stub.events.push_back(frame);
+        }
+        lazy.skeleton.animations.push_back(stub);
+    }
+    return std::move(lazy.skeleton);
+}
+
+}
+
+SpineVersion detectSpineVersion(const unsigned char* data, size_t size) {
+    // Use regex to find version pattern x.x.x
+    std::string header(reinterpret_cast<const char*>(data), std::min<size_t>(size, 256));
+    std::regex versionRegex(R"((\d+)\.(\d+)\.(\d+))");
+    std::smatch match;
+
+    if (std::regex_search(header, match, versionRegex)) {
+        std::string majorVersion = match[1].str();
+        std::string minorVersion = match[2].str();
+        std::string majorMinor = majorVersion + "." + minorVersion;
+
+        if (majorMinor == "3.5") {
+            return SpineVersion::Version35;
+        } else if (majorMinor == "3.6") {
+            return SpineVersion::Version36;
+        } else if (majorMinor == "3.7") {
+            return SpineVersion::Version37;
+        } else if (majorMinor == "3.8") {
+            return SpineVersion::Version38;
+        } else if (majorMinor == "4.0") {
+            return SpineVersion::Version40;
+        } else if (majorMinor == "4.1") {
+            return SpineVersion::Version41;
+        } else if (majorMinor == "4.2") {
+            return SpineVersion::Version42;
+        }
+    }
+    return SpineVersion::Invalid;
+}
+
+SpineVersion detectSpineVersion(const std::string& filePath) {
+    try {
+        std::ifstream ifs(filePath, std::ios::binary);
+        if (!ifs) return SpineVersion::Invalid;
+        
+        const size_t headerSize = 256;
+        unsigned char buffer[headerSize] = {0};
+        ifs.read(reinterpret_cast<char*>(buffer), headerSize);
+        return detectSpineVersion(buffer, static_cast<size_t>(ifs.gcount()));
+    }
+    catch (...) {
+        std::cerr << "Error: Failed to read file: " << filePath << "\n";
+    }
+    
+    return SpineVersion::Invalid;
+}
+
+FileFormat detectFileFormat(const std::string& filePath) {
+    std::string ext = std::filesystem::path(filePath).extension().string();
+    if (ext == ".json") return FileFormat::Json;
+    if (ext == ".skel") return FileFormat::Skel;
+    return FileFormat::Unknown;
+}
+
+FileFormat detectFileFormat(const unsigned char* data, size_t size) {
+    size_t i = size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF ? 3 : 0;
+    auto skipSpace = [&]() {
+        while (i < size && (data[i] == ' ' || data[i] == '\t' || data[i] == '\r' || data[i] == '\n')) i++;
+    };
+    skipSpace();
+    if (i == size || data[i] != '{') return size > 0 ? FileFormat::Skel : FileFormat::Unknown;
+    i++;
+    skipSpace();
+    return i < size && (data[i] == '"' || data[i] == '}') ? FileFormat::Json : FileFormat::Skel;
+}
+
+SkeletonData readSkeletonFile(const std::string& filePath) {
+    FileFormat format = detectFileFormat(filePath);
+    if (format == FileFormat::Unknown) throw std::runtime_error("Unsupported file extension: " + filePath);
+    SpineVersion version = detectSpineVersion(filePath);
+    if (version == SpineVersion::Invalid) throw std::runtime_error("Could not detect Spine version: " + filePath);
+    return readSkeletonData(filePath, format, version);
+}
+
+LazySkeletonData readBinaryDataLazy(Binary binaryData, SpineVersion inputVersion) {
+    switch (inputVersion) {
+        case SpineVersion::Version35: return spine35::readBinaryDataLazy(std::move(binaryData));
+        case SpineVersion::Version36: return spine36::readBinaryDataLazy(std::move(binaryData));
+        case SpineVersion::Version37: return spine37::readBinaryDataLazy(std::move(binaryData));
+        case SpineVersion::Version38: return spine38::readBinaryDataLazy(std::move(binaryData));
+        case SpineVersion::Version40: return spine40::readBinaryDataLazy(std::move(binaryData));
+        case SpineVersion::Version41: return spine41::readBinaryDataLazy(std::move(binaryData));
+        case SpineVersion::Version42: return spine42::readBinaryDataLazy(std::move(binaryData));
+        default: throw std::runtime_error("Unsupported input Spine version");
+    }
+}
+
+SkeletonData readSkeletonData(Binary content, FileFormat inputFormat, SpineVersion inputVersion,
+                              const std::vector<std::string>& animations, std::ostream& log) {
+    Json jsonData;
+    if (inputFormat == FileFormat::Json) {
+        jsonData = Json::parse(content.begin(), content.end());
+    } else if (!animations.empty()) {
+        return readRequestedAnimations(std::move(content), inputVersion, animations, log);
+    }
+
+    switch (inputVersion) {
+        case SpineVersion::Version35:
+            return inputFormat == FileFormat::Skel ? spine35::readBinaryData(content) : spine35::readJsonData(jsonData);
+        case SpineVersion::Version36:
+            return inputFormat == FileFormat::Skel ? spine36::readBinaryData(content) : spine36::readJsonData(jsonData);
+        case SpineVersion::Version37:
+            return inputFormat == FileFormat::Skel ? spine37::readBinaryData(content) : spine37::readJsonData(jsonData);
+        case SpineVersion::Version38:
+            return inputFormat == FileFormat::Skel ? spine38::readBinaryData(content) : spine38::readJsonData(jsonData);
+        case SpineVersion::Version40:
+            return inputFormat == FileFormat::Skel ? spine40::readBinaryData(content) : spine40::readJsonData(jsonData);
+        case SpineVersion::Version41:
+            return inputFormat == FileFormat::Skel ? spine41::readBinaryData(content) : spine41::readJsonData(jsonData);
+        case SpineVersion::Version42:
+            return inputFormat == FileFormat::Skel ? spine42::readBinaryData(content) : spine42::readJsonData(jsonData);
+        default:
+            throw std::runtime_error("Unsupported input Spine version");
+    }
+}
+
+SkeletonData readSkeletonData(const std::string& inputFile, FileFormat inputFormat, SpineVersion inputVersion,
+                              const std::vector<std::string>& animations) {
+    std::ifstream ifs(inputFile, std::ios::binary);
+    if (!ifs) throw std::runtime_error("Cannot open input file: " + inputFile);
+    Binary content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    return readSkeletonData(std::move(content), inputFormat, inputVersion, animations, std::cout);
+}
+
+Binary writeBinaryData(SkeletonData& skeleton, SpineVersion outputVersion, std::vector<AnimationRange>* animationRanges) {
+    switch (outputVersion) {
+        case SpineVersion::Version35: return spine35::writeBinaryData(skeleton, animationRanges);
+        case SpineVersion::Version36: return spine36::writeBinaryData(skeleton, animationRanges);
+        case SpineVersion::Version37: return spine37::writeBinaryData(skeleton, animationRanges);
+        case SpineVersion::Version38: return spine38::writeBinaryData(skeleton, animationRanges);
+        case SpineVersion::Version40: return spine40::writeBinaryData(skeleton, animationRanges);
+        case SpineVersion::Version41: return spine41::writeBinaryData(skeleton, animationRanges);
+        case SpineVersion::Version42: return spine42::writeBinaryData(skeleton, animationRanges);
+        default: throw std::runtime_error("Unsupported output Spine version");
+    }
+}
+
+Json writeJsonData(const SkeletonData& skeleton, SpineVersion outputVersion) {
+    switch (outputVersion) {
+        case SpineVersion::Version35: return spine35::writeJsonData(skeleton);
+        case SpineVersion::Version36: return spine36::writeJsonData(skeleton);
+        case SpineVersion::Version37: return spine37::writeJsonData(skeleton);
+        case SpineVersion::Version38: return spine38::writeJsonData(skeleton);
+        case SpineVersion::Version40: return spine40::writeJsonData(skeleton);
+        case SpineVersion::Version41: return spine41::writeJsonData(skeleton);
+        case SpineVersion::Version42: return spine42::writeJsonData(skeleton);
+        default: throw std::runtime_error("Unsupported output Spine version");
+    }
+}
+
+void writeSkeletonFile(SkeletonData& skeleton, const std::string& filePath, SpineVersion outputVersion) {
+    FileFormat format = detectFileFormat(filePath);
+    if (format == FileFormat::Unknown) throw std::runtime_error("Unsupported file extension: " + filePath);
+    if (format == FileFormat::Skel) {
+        Binary binary = writeBinaryData(skeleton, outputVersion);
+        std::ofstream ofs(filePath, std::ios::binary);
+        if (!ofs.write(reinterpret_cast<const char*>(binary.data()), binary.size())) throw std::runtime_error("Cannot write output file: " + filePath);
+    } else {
+        std::ofstream ofs(filePath);
+        if (!(ofs << dumpJson(writeJsonData(skeleton, outputVersion)))) throw std::runtime_error("Cannot write output file: " + filePath);
+    }
+}
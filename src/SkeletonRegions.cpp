@@ -0,0 +1,39 @@
+#include "SkeletonData.h"
+#include <set>
+
+std::string sequenceRegionName(const std::string& path, const Sequence& sequence, int index) {
+    std::string frame = std::to_string(sequence.start + index);
+    std::string name = path;
+    if (static_cast<int>(frame.size()) < sequence.digits) name.append(sequence.digits - frame.size(), '0');
+    return name + frame;
+}
+
+namespace {
+
+void addRegions(std::set<std::string>& names, const std::string& path, const OptSequence& sequence) {
+    if (!sequence) {
+        names.insert(path);
+        return;
+    }
+    for (int i = 0; i < sequence->count; i++) names.insert(sequenceRegionName(path, *sequence, i));
+}
+
+}
+
+std::vector<std::string> referencedRegions(const SkeletonData& skeleton) {
+    std::set<std::string> names;
+    for (const auto& skin : skeleton.skins) {
+        for (const auto& [slotName, slot] : skin.attachments) {
+            for (const auto& [attachmentName, attachment] : slot) {
+                std::visit([&](const auto& data) {
+                    using T = std::decay_t<decltype(data)>;
+                    if constexpr (std::is_same_v<T, RegionAttachment> || std::is_same_v<T, MeshAttachment> ||
+                                  std::is_same_v<T, LinkedmeshAttachment>) {
+                        addRegions(names, attachment.path, data.sequence);
+                    }
+                }, attachment.data);
+            }
+        }
+    }
+    return std::vector<std::string>(names.begin(), names.end());
+}
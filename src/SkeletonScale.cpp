@@ -0,0 +1,99 @@
+#include "SkeletonData.h"
+
+namespace {
+
+// Plain strided loops over contiguous floats; the stride 1 case is what unweighted vertices, path
+// lengths and deform keys use, and compilers vectorize it.
+void scaleFloats(float* values, size_t count, float scale) {
+    for (size_t i = 0; i < count; ++i) values[i] *= scale;
+}
+
+// Unweighted vertices are x, y pairs. Weighted ones are, per vertex, a bone count followed by
+// bone index, x, y and weight for each bone: only x and y are positions.
+void scaleVertices(std::vector<float>& vertices, bool weighted, float scale) {
+    if (!weighted) {
+        scaleFloats(vertices.data(), vertices.size(), scale);
+        return;
+    }
+    for (size_t i = 0; i < vertices.size();) {
+        size_t boneCount = static_cast<size_t>(vertices[i++]);
+        for (size_t b = 0; b < boneCount && i + 2 < vertices.size(); ++b, i += 4) {
+            vertices[i + 1] *= scale;
+            vertices[i + 2] *= scale;
+        }
+    }
+}
+
+void scaleAttachment(Attachment& attachment, float scale) {
+    std::visit([&](auto& data) {
+        using T = std::decay_t<decltype(data)>;
+        if constexpr (std::is_same_v<T, RegionAttachment>) {
+            data.x *= scale;
+            data.y *= scale;
+            data.width *= scale;
+            data.height *= scale;
+        } else if constexpr (std::is_same_v<T, MeshAttachment>) {
+            data.width *= scale;
+            data.height *= scale;
+            scaleVertices(data.vertices, data.vertices.size() != data.uvs.size(), scale);
+        } else if constexpr (std::is_same_v<T, LinkedmeshAttachment>) {
+            data.width *= scale;
+            data.height *= scale;
+        } else if constexpr (std::is_same_v<T, PathAttachment>) {
+            scaleVertices(data.vertices, data.vertices.size() != static_cast<size_t>(data.vertexCount) * 2, scale);
+            scaleFloats(data.lengths.data(), data.lengths.size(), scale);
+        } else if constexpr (std::is_same_v<T, PointAttachment>) {
+            data.x *= scale;
+            data.y *= scale;
+        } else {
+            // Bounding box and clipping attachments.
+            scaleVertices(data.vertices, data.vertices.size() != static_cast<size_t>(data.vertexCount) * 2, scale);
+        }
+    }, attachment.data);
+}
+
+}
+
+void scaleSkeleton(SkeletonData& skeleton, float scale) {
+    skeleton.x *= scale;
+    skeleton.y *= scale;
+    skeleton.width *= scale;
+    skeleton.height *= scale;
+    skeleton.referenceScale *= scale;
+    for (auto& bone : skeleton.bones) {
+        bone.x *= scale;
+        bone.y *= scale;
+        bone.length *= scale;
+    }
+    for (auto& ik : skeleton.ikConstraints) ik.softness *= scale;
+    for (auto& transform : skeleton.transformConstraints) {
+        transform.offsetX *= scale;
+        transform.offsetY *= scale;
+    }
+    for (auto& path : skeleton.pathConstraints) {
+        if (path.positionMode == PositionMode_Fixed) path.position *= scale;
+        if (path.spacingMode == SpacingMode_Length || path.spacingMode == SpacingMode_Fixed) path.spacing *= scale;
+    }
+    for (auto& physics : skeleton.physicsConstraints) physics.limit *= scale;
+    for (auto& skin : skeleton.skins)
+        for (auto& [slotName, slot] : skin.attachments)
+            for (auto& [attachmentName, attachment] : slot) scaleAttachment(attachment, scale);
+
+    // Keys in skeleton units, and in 4.x the value side of their bezier handles.
+    bool curves4x = uses4xCurves(skeleton);
+    forEachCurveTimeline(skeleton, [&](Timeline& timeline, const std::vector<CurveChannelSpec>& channels) {
+        for (size_t c = 0; c < channels.size(); ++c) {
+            if (channels[c].unit != ChannelUnit::Length) continue;
+            for (auto& frame : timeline) {
+                setCurveChannel(frame, channels[c].channel, getCurveChannel(frame, channels[c].channel) * scale);
+                if (curves4x && frame.curveType == CurveType::CURVE_BEZIER && frame.curve.size() >= c * 4 + 4) {
+                    frame.curve[c * 4 + 1] *= scale;
+                    frame.curve[c * 4 + 3] *= scale;
+                }
+            }
+        }
+    });
+    forEachDeformTimeline(skeleton, [&](Timeline& timeline) {
+        for (auto& frame : timeline) scaleFloats(frame.vertices.data(), frame.vertices.size(), scale);
+    });
+}
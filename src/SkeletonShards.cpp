@@ -0,0 +1,166 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+// A binary shard is the base hash (string), an animation count (varint), each animation's index in the
+// original skeleton (varints) and the animations exactly as the base's writer serialized them, so they decode
+// against the base's bone, slot, skin and string tables.
+// A JSON shard is {"skeleton": {"hash"}, "indices": {name: index}, "animations": {...}}.
+// Merging puts the animations back in index order, so the merged file matches an unsplit one.
+
+namespace {
+
+const AnimationRange& findRange(const std::vector<AnimationRange>& ranges, const std::string& name) {
+    auto it = std::find_if(ranges.begin(), ranges.end(), [&](const AnimationRange& range) { return range.name == name; });
+    if (it == ranges.end()) throw std::runtime_error("No animation named '" + name + "'");
+    return *it;
+}
+
+}
+
+std::string skeletonHashString(const SkeletonData& skeleton) {
+    return skeleton.hashString ? *skeleton.hashString : uint64ToBase64(skeleton.hash);
+}
+
+// FNV-1a
+uint64_t hashBytes(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::vector<AnimationGroup> groupAnimations(const SkeletonData& skeleton, const std::vector<AnimationGroup>& groups) {
+    std::vector<AnimationGroup> result;
+    std::set<std::string> grouped;
+    for (const auto& group : groups) {
+        for (const auto& name : group.animations) {
+            bool known = std::any_of(skeleton.animations.begin(), skeleton.animations.end(), [&](const Animation& animation) {
+                return animation.name == name;
+            });
+            if (!known) throw std::runtime_error("No animation named '" + name + "' in group '" + group.name + "'");
+            if (!grouped.insert(name).second) throw std::runtime_error("Animation '" + name + "' is in more than one group");
+        }
+        result.push_back(group);
+    }
+    for (const auto& animation : skeleton.animations) {
+        if (!grouped.count(animation.name)) result.push_back({animation.name, {animation.name}});
+    }
+    return result;
+}
+
+BinarySplit splitBinary(const Binary& binary, const std::vector<AnimationRange>& animationRanges, const std::string& hash, const std::vector<AnimationGroup>& groups) {
+    BinarySplit split;
+    if (animationRanges.empty()) {
+        split.base = binary;
+        return split;
+    }
+    // The animation count sits right before the first animation.
+    Binary count;
+    writeVarint(count, static_cast<int>(animationRanges.size()), true);
+    size_t header = animationRanges.front().offset - count.size();
+    split.base.assign(binary.begin(), binary.begin() + header);
+    writeVarint(split.base, 0, true);
+
+    for (const auto& group : groups) {
+        Binary shard;
+        writeString(shard, hash);
+        writeVarint(shard, static_cast<int>(group.animations.size()), true);
+        for (const auto& name : group.animations)
+            writeVarint(shard, static_cast<int>(&findRange(animationRanges, name) - animationRanges.data()), true);
+        for (const auto& name : group.animations) {
+            const AnimationRange& range = findRange(animationRanges, name);
+            shard.insert(shard.end(), binary.begin() + range.offset, binary.begin() + range.offset + range.size);
+        }
+        split.shards.push_back({group.name, shard});
+    }
+    return split;
+}
+
+Binary mergeBinary(const Binary& base, const std::string& hash, const std::vector<Binary>& shards) {
+    if (base.empty() || base.back() != 0) throw std::runtime_error("Base skeleton does not end with an empty animation list");
+    std::vector<int> indices;
+    Binary animations;
+    for (const auto& shard : shards) {
+        DataInput input;
+        input.cursor = shard.data();
+        input.end = shard.data() + shard.size();
+        OptStr shardHash = readString(&input);
+        if (shardHash != hash) throw std::runtime_error("Shard belongs to skeleton " + shardHash.value_or("(none)") + ", not " + hash);
+        int count = readVarint(&input, true);
+        for (int i = 0; i < count; i++) indices.push_back(readVarint(&input, true));
+        animations.insert(animations.end(), input.cursor, input.end);
+    }
+    Binary joined(base.begin(), base.end() - 1);
+    writeVarint(joined, static_cast<int>(indices.size()), true);
+    size_t header = joined.size();
+    joined.insert(joined.end(), animations.begin(), animations.end());
+    // Shards only hold serialized animations; skipping through the joined file yields their names and bytes.
+    std::vector<AnimationRange> ranges = readBinaryDataLazy(joined, detectSpineVersion(joined.data(), joined.size())).animationRanges;
+    if (ranges.size() != indices.size()) throw std::runtime_error("Shard animation counts do not match their contents");
+    std::set<std::string> names;
+    for (const auto& range : ranges)
+        if (!names.insert(range.name).second) throw std::runtime_error("Animation '" + range.name + "' is in more than one shard");
+
+    std::vector<const AnimationRange*> ordered(ranges.size(), nullptr);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (indices[i] < 0 || static_cast<size_t>(indices[i]) >= ordered.size() || ordered[indices[i]])
+            throw std::runtime_error("Shards do not hold one animation per original position (animation '" + ranges[i].name + "')");
+        ordered[indices[i]] = &ranges[i];
+    }
+    Binary merged(joined.begin(), joined.begin() + header);
+    for (const AnimationRange* range : ordered)
+        merged.insert(merged.end(), joined.begin() + range->offset, joined.begin() + range->offset + range->size);
+    return merged;
+}
+
+JsonSplit splitJson(const Json& json, const std::vector<AnimationGroup>& groups) {
+    JsonSplit split;
+    split.base = json;
+    split.base.erase("animations");
+    if (!json.contains("animations")) return split;
+
+    const Json& animations = json["animations"];
+    Json skeleton = Json::object();
+    if (json.contains("skeleton") && json["skeleton"].contains("hash")) skeleton["hash"] = json["skeleton"]["hash"];
+    for (const auto& group : groups) {
+        Json shard;
+        shard["skeleton"] = skeleton;
+        shard["indices"] = Json::object();
+        shard["animations"] = Json::object();
+        for (const auto& name : group.animations) {
+            if (!animations.contains(name)) throw std::runtime_error("No animation named '" + name + "'");
+            shard["indices"][name] = std::distance(animations.begin(), animations.find(name));
+            shard["animations"][name] = animations[name];
+        }
+        split.shards.push_back({group.name, shard});
+    }
+    return split;
+}
+
+Json mergeJson(const Json& base, const std::vector<Json>& shards) {
+    Json hash = base.contains("skeleton") && base["skeleton"].contains("hash") ? base["skeleton"]["hash"] : Json();
+    std::map<int, std::pair<std::string, const Json*>> ordered;
+    std::set<std::string> names;
+    for (const auto& shard : shards) {
+        Json shardHash = shard.contains("skeleton") && shard["skeleton"].contains("hash") ? shard["skeleton"]["hash"] : Json();
+        if (shardHash != hash) throw std::runtime_error("Shard belongs to skeleton " + shardHash.dump() + ", not " + hash.dump());
+        if (!shard.contains("animations")) continue;
+        for (const auto& item : shard["animations"].items()) {
+            const std::string& name = item.key();
+            if (!names.insert(name).second) throw std::runtime_error("Animation '" + name + "' is in more than one shard");
+            if (!shard.contains("indices") || !shard["indices"].contains(name) || !shard["indices"][name].is_number_integer())
+                throw std::runtime_error("Shard has no original index for animation '" + name + "'");
+            if (!ordered.emplace(shard["indices"][name].get<int>(), std::make_pair(name, &shard["animations"][name])).second)
+                throw std::runtime_error("Shards do not hold one animation per original position (animation '" + name + "')");
+        }
+    }
+    Json merged = base;
+    merged["animations"] = Json::object();
+    for (const auto& [index, animation] : ordered) merged["animations"][animation.first] = *animation.second;
+    return merged;
+}
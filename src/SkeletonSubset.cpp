@@ -0,0 +1,318 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+namespace {
+
+template <typename T, typename Pred>
+size_t eraseIf(std::vector<T>& items, Pred pred) {
+    auto it = std::remove_if(items.begin(), items.end(), pred);
+    size_t removed = static_cast<size_t>(std::distance(it, items.end()));
+    items.erase(it, items.end());
+    return removed;
+}
+
+template <typename Map, typename Pred>
+void eraseKeysIf(Map& map, Pred pred) {
+    for (auto it = map.begin(); it != map.end();) {
+        if (pred(it->first)) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Weighted vertex arrays of an attachment, which reference bones by index; nullptr when unweighted.
+std::vector<float>* weightedVertices(Attachment& attachment) {
+    if (auto* mesh = std::get_if<MeshAttachment>(&attachment.data))
+        return mesh->vertices.size() != mesh->uvs.size() ? &mesh->vertices : nullptr;
+    if (auto* box = std::get_if<BoundingboxAttachment>(&attachment.data))
+        return box->vertices.size() != static_cast<size_t>(box->vertexCount) * 2 ? &box->vertices : nullptr;
+    if (auto* path = std::get_if<PathAttachment>(&attachment.data))
+        return path->vertices.size() != static_cast<size_t>(path->vertexCount) * 2 ? &path->vertices : nullptr;
+    if (auto* clipping = std::get_if<ClippingAttachment>(&attachment.data))
+        return clipping->vertices.size() != static_cast<size_t>(clipping->vertexCount) * 2 ? &clipping->vertices : nullptr;
+    return nullptr;
+}
+
+template <typename Visit>
+void forEachWeightedBone(std::vector<float>& vertices, Visit visit) {
+    size_t i = 0;
+    while (i < vertices.size()) {
+        size_t boneCount = static_cast<size_t>(vertices[i++]);
+        for (size_t j = 0; j < boneCount && i < vertices.size(); ++j, i += 4) visit(vertices[i]);
+    }
+}
+
+struct Reachability {
+    std::set<std::string> bones, slots, ik, transform, path, physics, events;
+
+    Reachability minus(const Reachability& other) const {
+        Reachability result;
+        auto difference = [](const std::set<std::string>& a, const std::set<std::string>& b, std::set<std::string>& out) {
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(out, out.end()));
+        };
+        difference(bones, other.bones, result.bones);
+        difference(slots, other.slots, result.slots);
+        difference(ik, other.ik, result.ik);
+        difference(transform, other.transform, result.transform);
+        difference(path, other.path, result.path);
+        difference(physics, other.physics, result.physics);
+        difference(events, other.events, result.events);
+        return result;
+    }
+};
+
+Reachability allItems(const SkeletonData& skeleton) {
+    Reachability all;
+    for (const auto& bone : skeleton.bones) all.bones.insert(bone.name.value_or(""));
+    for (const auto& slot : skeleton.slots) all.slots.insert(slot.name.value_or(""));
+    for (const auto& ik : skeleton.ikConstraints) all.ik.insert(ik.name.value_or(""));
+    for (const auto& transform : skeleton.transformConstraints) all.transform.insert(transform.name.value_or(""));
+    for (const auto& path : skeleton.pathConstraints) all.path.insert(path.name.value_or(""));
+    for (const auto& physics : skeleton.physicsConstraints) all.physics.insert(physics.name.value_or(""));
+    for (const auto& event : skeleton.events) all.events.insert(event.name);
+    return all;
+}
+
+// Items reachable from the skins (slots holding attachments, the bones they and their weights use)
+// and the events fired by animations, closed over parents, constraints acting on reachable bones and
+// constraint targets. Items in `forced` count as reachable whatever refers to them.
+Reachability findReachable(SkeletonData& skeleton, const Reachability* forced) {
+    Reachability reachable;
+    std::map<std::string, const BoneData*> bonesByName;
+    for (const auto& bone : skeleton.bones) bonesByName[bone.name.value_or("")] = &bone;
+    auto markBone = [&](const std::string& name) {
+        for (auto it = bonesByName.find(name); it != bonesByName.end() && reachable.bones.insert(it->first).second;) {
+            if (!it->second->parent) break;
+            it = bonesByName.find(*it->second->parent);
+        }
+    };
+    auto markSlot = [&](const std::string& name) {
+        if (!reachable.slots.insert(name).second) return;
+        for (const auto& slot : skeleton.slots)
+            if (slot.name == name && slot.bone) markBone(*slot.bone);
+    };
+    auto anyBoneReachable = [&](const std::vector<std::string>& bones) {
+        return std::any_of(bones.begin(), bones.end(), [&](const std::string& name) { return reachable.bones.count(name) > 0; });
+    };
+    auto isForced = [&](const std::set<std::string> Reachability::* items, const OptStr& name) {
+        return forced && (forced->*items).count(name.value_or("")) > 0;
+    };
+
+    if (!skeleton.bones.empty()) markBone(skeleton.bones[0].name.value_or(""));
+    if (forced) {
+        for (const auto& bone : forced->bones) markBone(bone);
+        for (const auto& slot : forced->slots) markSlot(slot);
+        reachable.events = forced->events;
+    }
+    for (auto& skin : skeleton.skins) {
+        for (const auto& bone : skin.bones) markBone(bone);
+        for (auto& [slotName, attachments] : skin.attachments) {
+            if (attachments.empty()) continue;
+            markSlot(slotName);
+            for (auto& [attachmentName, attachment] : attachments) {
+                if (auto* clipping = std::get_if<ClippingAttachment>(&attachment.data); clipping && clipping->endSlot)
+                    markSlot(*clipping->endSlot);
+                if (auto* vertices = weightedVertices(attachment))
+                    forEachWeightedBone(*vertices, [&](float index) {
+                        size_t bone = static_cast<size_t>(index);
+                        if (bone < skeleton.bones.size()) markBone(skeleton.bones[bone].name.value_or(""));
+                    });
+            }
+        }
+    }
+    for (const auto& animation : skeleton.animations)
+        for (const auto& frame : animation.events)
+            if (frame.str1) reachable.events.insert(*frame.str1);
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& ik : skeleton.ikConstraints) {
+            if (reachable.ik.count(ik.name.value_or("")) || !(isForced(&Reachability::ik, ik.name) || anyBoneReachable(ik.bones))) continue;
+            reachable.ik.insert(ik.name.value_or(""));
+            for (const auto& bone : ik.bones) markBone(bone);
+            if (ik.target) markBone(*ik.target);
+            changed = true;
+        }
+        for (const auto& transform : skeleton.transformConstraints) {
+            if (reachable.transform.count(transform.name.value_or("")) || !(isForced(&Reachability::transform, transform.name) || anyBoneReachable(transform.bones))) continue;
+            reachable.transform.insert(transform.name.value_or(""));
+            for (const auto& bone : transform.bones) markBone(bone);
+            if (transform.target) markBone(*transform.target);
+            changed = true;
+        }
+        for (const auto& path : skeleton.pathConstraints) {
+            if (reachable.path.count(path.name.value_or("")) || !(isForced(&Reachability::path, path.name) || anyBoneReachable(path.bones))) continue;
+            reachable.path.insert(path.name.value_or(""));
+            for (const auto& bone : path.bones) markBone(bone);
+            if (path.target) markSlot(*path.target);
+            changed = true;
+        }
+        for (const auto& physics : skeleton.physicsConstraints) {
+            if (reachable.physics.count(physics.name.value_or("")) || !physics.bone) continue;
+            if (!isForced(&Reachability::physics, physics.name) && !reachable.bones.count(*physics.bone)) continue;
+            reachable.physics.insert(physics.name.value_or(""));
+            markBone(*physics.bone);
+            changed = true;
+        }
+    }
+    return reachable;
+}
+
+// Slot index at each draw order position, decoded the way the runtimes apply a draw order key.
+std::vector<size_t> decodeDrawOrder(const TimelineFrame& frame, const std::map<std::string, size_t>& slotIndices, size_t slotCount) {
+    std::vector<std::pair<size_t, int>> offsets;
+    for (const auto& [slotName, offset] : frame.offsets) {
+        auto it = slotIndices.find(slotName);
+        if (it != slotIndices.end()) offsets.push_back({ it->second, offset });
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    const size_t empty = slotCount;
+    std::vector<size_t> drawOrder(slotCount, empty), unchanged;
+    size_t originalIndex = 0;
+    for (const auto& [slotIndex, offset] : offsets) {
+        while (originalIndex != slotIndex) unchanged.push_back(originalIndex++);
+        size_t position = originalIndex + offset;
+        if (position < slotCount) drawOrder[position] = originalIndex;
+        originalIndex++;
+    }
+    while (originalIndex < slotCount) unchanged.push_back(originalIndex++);
+    for (size_t i = slotCount; i-- > 0;)
+        if (drawOrder[i] == empty && !unchanged.empty()) {
+            drawOrder[i] = unchanged.back();
+            unchanged.pop_back();
+        }
+    return drawOrder;
+}
+
+std::vector<std::pair<std::string, int>> encodeDrawOrder(const std::vector<size_t>& drawOrder, const std::vector<SlotData>& slots) {
+    std::vector<int> positions(drawOrder.size());
+    for (size_t i = 0; i < drawOrder.size(); ++i) positions[drawOrder[i]] = static_cast<int>(i);
+    std::vector<std::pair<std::string, int>> offsets;
+    for (size_t slot = 0; slot < slots.size(); ++slot)
+        if (positions[slot] != static_cast<int>(slot)) offsets.push_back({ slots[slot].name.value_or(""), positions[slot] - static_cast<int>(slot) });
+    return offsets;
+}
+
+// Skins referenced by the linked meshes of a skin, which need their parent mesh.
+std::set<std::string> linkedParentSkins(const Skin& skin) {
+    std::set<std::string> parents;
+    for (const auto& [slotName, attachments] : skin.attachments)
+        for (const auto& [attachmentName, attachment] : attachments)
+            if (const auto* linked = std::get_if<LinkedmeshAttachment>(&attachment.data))
+                parents.insert(linked->skin.value_or("default"));
+    return parents;
+}
+
+}
+
+SubsetStats subsetSkeleton(SkeletonData& skeleton, const std::vector<std::string>& animations, const std::vector<std::string>& skins) {
+    SubsetStats stats;
+    // Items the source itself never references (bones only looked up by game code, unused events) are
+    // kept: only what the subset makes unreachable is removed.
+    Reachability neverReferenced = allItems(skeleton).minus(findReachable(skeleton, nullptr));
+
+    /* animations and skins */
+    if (!animations.empty()) {
+        for (const auto& name : animations)
+            if (std::none_of(skeleton.animations.begin(), skeleton.animations.end(), [&](const Animation& a) { return a.name == name; }))
+                stats.unknownNames.push_back(name);
+        stats.removedAnimations = eraseIf(skeleton.animations, [&](const Animation& animation) {
+            return std::find(animations.begin(), animations.end(), animation.name) == animations.end();
+        });
+    }
+    if (!skins.empty()) {
+        for (const auto& name : skins)
+            if (std::none_of(skeleton.skins.begin(), skeleton.skins.end(), [&](const Skin& s) { return s.name == name; }))
+                stats.unknownNames.push_back(name);
+        // The default skin holds the setup pose attachments and is always kept.
+        std::set<std::string> keptSkins(skins.begin(), skins.end());
+        keptSkins.insert("default");
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (const auto& skin : skeleton.skins)
+                if (keptSkins.count(skin.name))
+                    for (const auto& parent : linkedParentSkins(skin)) changed |= keptSkins.insert(parent).second;
+        }
+        stats.removedSkins = eraseIf(skeleton.skins, [&](const Skin& skin) { return !keptSkins.count(skin.name); });
+    }
+
+    Reachability reachable = findReachable(skeleton, &neverReferenced);
+
+    /* bones, with weighted vertices renumbered */
+    std::vector<int> boneRemap(skeleton.bones.size(), -1);
+    std::vector<BoneData> bones;
+    for (size_t i = 0; i < skeleton.bones.size(); ++i) {
+        if (!reachable.bones.count(skeleton.bones[i].name.value_or(""))) continue;
+        boneRemap[i] = static_cast<int>(bones.size());
+        bones.push_back(skeleton.bones[i]);
+    }
+    stats.removedBones = skeleton.bones.size() - bones.size();
+    skeleton.bones = std::move(bones);
+    for (auto& skin : skeleton.skins)
+        for (auto& [slotName, attachments] : skin.attachments)
+            for (auto& [attachmentName, attachment] : attachments)
+                if (auto* vertices = weightedVertices(attachment))
+                    forEachWeightedBone(*vertices, [&](float& index) {
+                        size_t bone = static_cast<size_t>(index);
+                        if (bone < boneRemap.size() && boneRemap[bone] >= 0) index = static_cast<float>(boneRemap[bone]);
+                    });
+
+    /* slots, with draw order keys re-encoded against the remaining slots */
+    std::map<std::string, size_t> oldSlotIndices;
+    for (size_t i = 0; i < skeleton.slots.size(); ++i) oldSlotIndices[skeleton.slots[i].name.value_or("")] = i;
+    std::vector<SlotData> oldSlots = skeleton.slots;
+    stats.removedSlots = eraseIf(skeleton.slots, [&](const SlotData& slot) { return !reachable.slots.count(slot.name.value_or("")); });
+    if (stats.removedSlots > 0) {
+        std::map<std::string, size_t> newSlotIndices;
+        for (size_t i = 0; i < skeleton.slots.size(); ++i) newSlotIndices[skeleton.slots[i].name.value_or("")] = i;
+        for (auto& animation : skeleton.animations) {
+            for (auto& frame : animation.drawOrder) {
+                if (frame.offsets.empty()) continue;
+                std::vector<size_t> drawOrder;
+                for (size_t slot : decodeDrawOrder(frame, oldSlotIndices, oldSlots.size())) {
+                    auto it = newSlotIndices.find(oldSlots[slot].name.value_or(""));
+                    if (it != newSlotIndices.end()) drawOrder.push_back(it->second);
+                }
+                frame.offsets = encodeDrawOrder(drawOrder, skeleton.slots);
+            }
+        }
+    }
+
+    /* constraints */
+    stats.removedConstraints += eraseIf(skeleton.ikConstraints, [&](const IKConstraintData& c) { return !reachable.ik.count(c.name.value_or("")); });
+    stats.removedConstraints += eraseIf(skeleton.transformConstraints, [&](const TransformConstraintData& c) { return !reachable.transform.count(c.name.value_or("")); });
+    stats.removedConstraints += eraseIf(skeleton.pathConstraints, [&](const PathConstraintData& c) { return !reachable.path.count(c.name.value_or("")); });
+    stats.removedConstraints += eraseIf(skeleton.physicsConstraints, [&](const PhysicsConstraintData& c) { return !reachable.physics.count(c.name.value_or("")); });
+    // Runtimes only update constraints whose order is below the constraint count.
+    if (stats.removedConstraints > 0) compactConstraintOrders(skeleton);
+    for (auto& skin : skeleton.skins) {
+        eraseIf(skin.bones, [&](const std::string& name) { return !reachable.bones.count(name); });
+        eraseIf(skin.ik, [&](const std::string& name) { return !reachable.ik.count(name); });
+        eraseIf(skin.transform, [&](const std::string& name) { return !reachable.transform.count(name); });
+        eraseIf(skin.path, [&](const std::string& name) { return !reachable.path.count(name); });
+        eraseIf(skin.physics, [&](const std::string& name) { return !reachable.physics.count(name); });
+    }
+
+    /* timelines of removed items, then events */
+    std::set<std::string> keptSkins;
+    for (const auto& skin : skeleton.skins) keptSkins.insert(skin.name);
+    for (auto& animation : skeleton.animations) {
+        eraseKeysIf(animation.bones, [&](const std::string& name) { return !reachable.bones.count(name); });
+        eraseKeysIf(animation.slots, [&](const std::string& name) { return !reachable.slots.count(name); });
+        eraseKeysIf(animation.ik, [&](const std::string& name) { return !reachable.ik.count(name); });
+        eraseKeysIf(animation.transform, [&](const std::string& name) { return !reachable.transform.count(name); });
+        eraseKeysIf(animation.path, [&](const std::string& name) { return !reachable.path.count(name); });
+        // An empty physics constraint name keys the timelines applying to all physics constraints.
+        eraseKeysIf(animation.physics, [&](const std::string& name) { return !name.empty() && !reachable.physics.count(name); });
+        eraseKeysIf(animation.attachments, [&](const std::string& name) { return !keptSkins.count(name); });
+        for (auto& [skinName, slots] : animation.attachments)
+            eraseKeysIf(slots, [&](const std::string& name) { return !reachable.slots.count(name); });
+    }
+    stats.removedEvents = eraseIf(skeleton.events, [&](const EventData& event) { return !reachable.events.count(event.name); });
+    return stats;
+}
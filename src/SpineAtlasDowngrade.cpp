@@ -1,23 +1,49 @@
 // Spine Atlas 4.x to 3.x Downgrader implemented in C++
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <vector>
 
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define STBI_FAILURE_USERMSG
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image_write.h"
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "stb_image_resize2.h"
 
+#include "MaxRectsPacker.h"
+#include "PngWriter.h"
+#include "SkeletonData.h"
+
 namespace fs = std::filesystem;
 
 struct AtlasRegion {
@@ -57,7 +83,10 @@ struct AtlasData {
 
 namespace {
 
-std::string trim(const std::string& input) {
+// Output rows buffered between the resizer and the PNG encoder.
+constexpr int stripHeight = 16;
+
+std::string_view trim(std::string_view input) {
 	size_t start = 0;
 	size_t end = input.size();
 	while (start < end && std::isspace(static_cast<unsigned char>(input[start]))) {
@@ -69,69 +98,125 @@ std::string trim(const std::string& input) {
 	return input.substr(start, end - start);
 }
 
-bool parseInt(const std::string& text, int& value) {
-	try {
-		size_t idx = 0;
-		int v = std::stoi(text, &idx, 10);
-		if (idx != text.size()) {
-			return false;
-		}
-		value = v;
-		return true;
-	} catch (...) {
+bool parseInt(std::string_view text, int& value) {
+	int v = 0;
+	auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+	if (ec != std::errc() || end != text.data() + text.size() || text.empty()) {
+		return false;
+	}
+	value = v;
+	return true;
+}
+
+bool parseDouble(std::string_view text, double& value) {
+	double v = 0.0;
+	auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+	if (ec != std::errc() || end != text.data() + text.size() || text.empty()) {
 		return false;
 	}
+	value = v;
+	return true;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+		return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+	});
 }
 
 int roundScaled(int value, double scale) {
 	return scale != 1.0 ? static_cast<int>(std::lround(static_cast<double>(value) / scale)) : value;
 }
 
-std::pair<std::string, std::vector<std::string>> parseEntry(const std::string& line) {
-	auto colonPos = line.find(':');
-	if (colonPos == std::string::npos) {
-		return {"", {}};
+// Takes the next line off the front of `text`, without its line break; false at the end.
+bool nextLine(std::string_view& text, std::string_view& line) {
+	if (text.empty()) {
+		return false;
 	}
-
-	std::string key = trim(line.substr(0, colonPos));
-	std::string valuesStr = trim(line.substr(colonPos + 1));
-
-	std::vector<std::string> values;
-	std::string current;
-	std::istringstream ss(valuesStr);
-	while (std::getline(ss, current, ',')) {
-		values.push_back(trim(current));
+	size_t end = text.find('\n');
+	line = text.substr(0, end);
+	text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+	if (!line.empty() && line.back() == '\r') {
+		line.remove_suffix(1);
 	}
+	return true;
+}
 
-	return {key, values};
+// Comma separated values, trimmed; they point into `text`.
+void splitValues(std::string_view text, std::vector<std::string_view>& values) {
+	values.clear();
+	while (true) {
+		size_t comma = text.find(',');
+		values.push_back(trim(text.substr(0, comma)));
+		if (comma == std::string_view::npos) {
+			break;
+		}
+		text.remove_prefix(comma + 1);
+	}
 }
 
-AtlasData readAtlasData4x(const std::string& content) {
-	AtlasData atlas;
-	std::vector<std::string> lines;
-	std::istringstream stream(content);
-	std::string line;
-	while (std::getline(stream, line)) {
-		lines.push_back(line);
+// Splits a trimmed "key: a, b, c" line into its key and values. False if the line has no colon.
+bool parseEntry(std::string_view line, std::string_view& key, std::vector<std::string_view>& values) {
+	size_t colon = line.find(':');
+	if (colon == std::string_view::npos) {
+		return false;
 	}
+	key = trim(line.substr(0, colon));
+	splitValues(line.substr(colon + 1), values);
+	return true;
+}
 
+// Reads a 4.x or 3.x atlas in one pass, without copying lines; the result does not point into
+// `content`. A page starts at the first name, at a name after a blank line, or at a name followed by a
+// size entry (atlases written without blank lines between pages); any other name starts a region of the
+// current page. The first malformed number is reported in `error` with its line, and skipped.
+AtlasData readAtlasData(std::string_view content, std::string* error = nullptr) {
+	AtlasData atlas;
 	AtlasPage* currentPage = nullptr;
-	size_t i = 0;
-	while (i < lines.size()) {
-		std::string trimmed = trim(lines[i]);
+	bool pageEnded = true;
+	size_t lineNumber = 0;
+	std::string_view line;
+	std::string_view key;
+	std::vector<std::string_view> values;
+	auto number = [&](std::string_view text, int& value) {
+		if (parseInt(text, value)) {
+			return true;
+		}
+		if (error && error->empty()) {
+			*error = "line " + std::to_string(lineNumber) + ": invalid number '" + std::string(text) + "'";
+		}
+		return false;
+	};
+	auto numbers = [&](std::vector<int>& target) {
+		target.clear();
+		for (std::string_view entry : values) {
+			int value = 0;
+			if (number(entry, value)) {
+				target.push_back(value);
+			}
+		}
+	};
+
+	if (content.size() >= 3 && content.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+		content.remove_prefix(3);
+	}
+	while (nextLine(content, line)) {
+		++lineNumber;
+		std::string_view trimmed = trim(line);
 		if (trimmed.empty()) {
-			++i;
+			pageEnded = true;
 			continue;
 		}
 
-		if (trimmed.find(':') == std::string::npos) {
-			bool isPageStart = false;
-			if (i + 1 < lines.size()) {
-				std::string nextTrimmed = trim(lines[i + 1]);
-				if (!nextTrimmed.empty() && nextTrimmed.rfind("size:", 0) == 0) {
-					isPageStart = true;
-				}
+		if (!parseEntry(trimmed, key, values)) {
+			bool isPageStart = pageEnded;
+			std::string_view rest = content;
+			std::string_view next;
+			if (!isPageStart && nextLine(rest, next)) {
+				next = trim(next);
+				isPageStart = next.size() >= 5 && next.compare(0, 5, "size:") == 0;
 			}
+			pageEnded = false;
 
 			if (isPageStart) {
 				atlas.pages.emplace_back();
@@ -141,14 +226,9 @@ AtlasData readAtlasData4x(const std::string& content) {
 				currentPage->regions.emplace_back();
 				currentPage->regions.back().name = trimmed;
 			}
-
-			++i;
 			continue;
 		}
-
-		auto [key, values] = parseEntry(trimmed);
 		if (key.empty()) {
-			++i;
 			continue;
 		}
 
@@ -156,25 +236,19 @@ AtlasData readAtlasData4x(const std::string& content) {
 			(key == "size" || key == "format" || key == "filter" ||
 			 key == "repeat" || key == "pma" || key == "scale")) {
 			if (key == "size" && values.size() >= 2) {
-				int w = 0;
-				int h = 0;
-				if (parseInt(values[0], w)) currentPage->width = w;
-				if (parseInt(values[1], h)) currentPage->height = h;
-			} else if (key == "format" && !values.empty()) {
+				number(values[0], currentPage->width);
+				number(values[1], currentPage->height);
+			} else if (key == "format") {
 				currentPage->format = values[0];
 			} else if (key == "filter" && values.size() >= 2) {
 				currentPage->minFilter = values[0];
 				currentPage->magFilter = values[1];
-			} else if (key == "repeat" && !values.empty()) {
+			} else if (key == "repeat") {
 				currentPage->repeat = values[0];
-			} else if (key == "pma" && !values.empty()) {
-				std::string lowered = values[0];
-				std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-				currentPage->pma = (lowered == "true");
-			} else if (key == "scale" && !values.empty()) {
-				try {
-					currentPage->scale = std::stod(values[0]);
-				} catch (...) {
+			} else if (key == "pma") {
+				currentPage->pma = equalsIgnoreCase(values[0], "true");
+			} else if (key == "scale") {
+				if (!parseDouble(values[0], currentPage->scale)) {
 					currentPage->scale = 1.0;
 				}
 			}
@@ -182,67 +256,50 @@ AtlasData readAtlasData4x(const std::string& content) {
 			AtlasRegion& region = currentPage->regions.back();
 
 			if (key == "bounds" && values.size() >= 4) {
-				parseInt(values[0], region.x);
-				parseInt(values[1], region.y);
-				parseInt(values[2], region.width);
-				parseInt(values[3], region.height);
+				number(values[0], region.x);
+				number(values[1], region.y);
+				number(values[2], region.width);
+				number(values[3], region.height);
 			} else if (key == "xy" && values.size() >= 2) {
-				parseInt(values[0], region.x);
-				parseInt(values[1], region.y);
+				number(values[0], region.x);
+				number(values[1], region.y);
 			} else if (key == "size" && values.size() >= 2) {
-				parseInt(values[0], region.width);
-				parseInt(values[1], region.height);
+				number(values[0], region.width);
+				number(values[1], region.height);
 			} else if (key == "offset" && values.size() >= 2) {
-				parseInt(values[0], region.offsetX);
-				parseInt(values[1], region.offsetY);
+				number(values[0], region.offsetX);
+				number(values[1], region.offsetY);
 			} else if (key == "offsets" && values.size() >= 4) {
-				parseInt(values[0], region.offsetX);
-				parseInt(values[1], region.offsetY);
-				parseInt(values[2], region.originalWidth);
-				parseInt(values[3], region.originalHeight);
+				number(values[0], region.offsetX);
+				number(values[1], region.offsetY);
+				number(values[2], region.originalWidth);
+				number(values[3], region.originalHeight);
 			} else if (key == "orig" && values.size() >= 2) {
-				parseInt(values[0], region.originalWidth);
-				parseInt(values[1], region.originalHeight);
-			} else if (key == "rotate" && !values.empty()) {
-				std::string lowered = values[0];
-				std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-				if (lowered == "true") {
+				number(values[0], region.originalWidth);
+				number(values[1], region.originalHeight);
+			} else if (key == "rotate") {
+				if (equalsIgnoreCase(values[0], "true")) {
 					region.degrees = 90;
-				} else if (lowered == "false") {
+				} else if (equalsIgnoreCase(values[0], "false")) {
 					region.degrees = 0;
 				} else {
-					parseInt(values[0], region.degrees);
+					number(values[0], region.degrees);
 				}
-			} else if (key == "index" && !values.empty()) {
-				parseInt(values[0], region.index);
+			} else if (key == "index") {
+				number(values[0], region.index);
 			} else if (key == "split" && values.size() >= 4) {
-				region.splits.clear();
-				for (const auto& entry : values) {
-					int val = 0;
-					if (parseInt(entry, val)) {
-						region.splits.push_back(val);
-					}
-				}
+				numbers(region.splits);
 			} else if (key == "pad" && values.size() >= 4) {
-				region.pads.clear();
-				for (const auto& entry : values) {
-					int val = 0;
-					if (parseInt(entry, val)) {
-						region.pads.push_back(val);
-					}
-				}
+				numbers(region.pads);
 			} else {
-				region.names.push_back(key);
-				for (const auto& entry : values) {
-					int val = 0;
-					if (parseInt(entry, val)) {
-						region.values.push_back(val);
-					}
+				region.names.emplace_back(key);
+				for (std::string_view entry : values) {
+					int value = 0;
+					number(entry, value);
+					region.values.push_back(value);
 				}
 			}
 		}
-
-		++i;
 	}
 
 	return atlas;
@@ -334,6 +391,75 @@ std::string writeAtlasData3x(const AtlasData& atlas) {
 	return output.str();
 }
 
+// Region values written as entries of equal length, the way the 4.x reader flattened them.
+void writeCustomValues(std::ostringstream& output, const AtlasRegion& region) {
+	if (region.names.empty() || region.values.size() % region.names.size() != 0) {
+		return;
+	}
+	size_t count = region.values.size() / region.names.size();
+	for (size_t n = 0; n < region.names.size(); ++n) {
+		output << '\t' << region.names[n] << ": ";
+		for (size_t idx = 0; idx < count; ++idx) {
+			output << region.values[n * count + idx] << (idx + 1 < count ? ", " : "");
+		}
+		output << '\n';
+	}
+}
+
+std::string writeAtlasData4x(const AtlasData& atlas) {
+	std::ostringstream output;
+
+	for (size_t pageIndex = 0; pageIndex < atlas.pages.size(); ++pageIndex) {
+		const AtlasPage& page = atlas.pages[pageIndex];
+		if (pageIndex > 0) {
+			output << '\n';
+		}
+		output << page.name << '\n';
+		output << "\tsize: " << page.width << ", " << page.height << '\n';
+		if (page.format != "RGBA8888") {
+			output << "\tformat: " << page.format << '\n';
+		}
+		if (page.minFilter != "Nearest" || page.magFilter != "Nearest") {
+			output << "\tfilter: " << page.minFilter << ", " << page.magFilter << '\n';
+		}
+		if (page.repeat != "none") {
+			output << "\trepeat: " << page.repeat << '\n';
+		}
+		if (page.pma) {
+			output << "\tpma: true\n";
+		}
+		if (page.scale != 0.0 && page.scale != 1.0) {
+			output << "\tscale: " << page.scale << '\n';
+		}
+
+		for (const auto& region : page.regions) {
+			output << region.name << '\n';
+			output << "\tbounds: " << region.x << ", " << region.y << ", " << region.width << ", " << region.height << '\n';
+
+			int origWidth = region.originalWidth > 0 ? region.originalWidth : region.width;
+			int origHeight = region.originalHeight > 0 ? region.originalHeight : region.height;
+			if (region.offsetX != 0 || region.offsetY != 0 || origWidth != region.width || origHeight != region.height) {
+				output << "\toffsets: " << region.offsetX << ", " << region.offsetY << ", " << origWidth << ", " << origHeight << '\n';
+			}
+			if (region.degrees != 0) {
+				output << "\trotate: " << region.degrees << '\n';
+			}
+			if (region.splits.size() >= 4) {
+				output << "\tsplit: " << region.splits[0] << ", " << region.splits[1] << ", " << region.splits[2] << ", " << region.splits[3] << '\n';
+			}
+			if (region.pads.size() >= 4) {
+				output << "\tpad: " << region.pads[0] << ", " << region.pads[1] << ", " << region.pads[2] << ", " << region.pads[3] << '\n';
+			}
+			writeCustomValues(output, region);
+			if (region.index != -1) {
+				output << "\tindex: " << region.index << '\n';
+			}
+		}
+	}
+
+	return output.str();
+}
+
 bool writeFile(const fs::path& path, const std::string& content) {
 	std::ofstream ofs(path, std::ios::trunc);
 	if (!ofs) {
@@ -343,172 +469,1277 @@ bool writeFile(const fs::path& path, const std::string& content) {
 	return true;
 }
 
-bool readFile(const fs::path& path, std::string& out) {
-	std::ifstream ifs(path, std::ios::binary);
-	if (!ifs) {
-		return false;
+// A whole file as read-only memory: mapped where the platform allows it, otherwise (empty files,
+// special files) read into a buffer.
+class MappedFile {
+public:
+	explicit MappedFile(const fs::path& path) {
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file != INVALID_HANDLE_VALUE) {
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+				mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping_) {
+					data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+					size_ = static_cast<size_t>(size.QuadPart);
+				}
+			}
+			CloseHandle(file);
+		}
+#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file >= 0) {
+			struct stat info;
+			if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+				void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+				if (data != MAP_FAILED) {
+					data_ = static_cast<const char*>(data);
+					size_ = static_cast<size_t>(info.st_size);
+				}
+			}
+			close(file);
+		}
+#endif
+		mapped_ = data_ != nullptr;
+		if (!mapped_) {
+			std::ifstream ifs(path, std::ios::binary);
+			if (!ifs) {
+				return;
+			}
+			buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+			data_ = buffer_.data();
+			size_ = buffer_.size();
+		}
+		ok_ = true;
 	}
-	std::ostringstream ss;
-	ss << ifs.rdbuf();
-	out = ss.str();
-	return true;
-}
 
-bool scaleImageWithStb(const fs::path& inputPath, const fs::path& outputPath, double scaleFactor) {
+	~MappedFile() {
+#ifdef _WIN32
+		if (mapped_) {
+			UnmapViewOfFile(data_);
+		}
+		if (mapping_) {
+			CloseHandle(mapping_);
+		}
+#else
+		if (mapped_) {
+			munmap(const_cast<char*>(data_), size_);
+		}
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool ok() const { return ok_; }
+	std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+	bool mapped_ = false;
+	bool ok_ = false;
+	std::string buffer_;
+#ifdef _WIN32
+	HANDLE mapping_ = nullptr;
+#endif
+};
+
+// Decoded or composed page kept in memory, 8-bit RGBA.
+struct RgbaImage {
 	int width = 0;
 	int height = 0;
-	int channels = 0;
-	stbi_uc* data = stbi_load(inputPath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
-	if (!data) {
-		const char* reason = stbi_failure_reason();
-		if (reason) {
-			std::cout << "  [ERROR] stb_image failed to load '" << inputPath.string() << "': " << reason << std::endl;
+	std::vector<unsigned char> pixels;
+};
+
+// Runs task(i) for every i below `count` on up to `jobs` threads.
+template <typename Task>
+void parallelFor(size_t count, unsigned int jobs, Task task) {
+	std::atomic<size_t> next = 0;
+	auto worker = [&]() {
+		for (size_t i = next++; i < count; i = next++) {
+			task(i);
 		}
-		return false;
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int i = 0; i < std::min<size_t>(std::max(1u, jobs), count); ++i) {
+		threads.emplace_back(worker);
 	}
-	if (scaleFactor == 0.0) {
-		stbi_image_free(data);
-		return false;
+	for (auto& thread : threads) {
+		thread.join();
 	}
+}
 
-	channels = 4;
-	int outWidth = static_cast<int>(std::lround(static_cast<double>(width) / scaleFactor));
-	int outHeight = static_cast<int>(std::lround(static_cast<double>(height) / scaleFactor));
-	outWidth = std::max(1, outWidth);
-	outHeight = std::max(1, outHeight);
+// Straight to premultiplied alpha, c * a / 255 rounded. Whole pixels per iteration with no branches
+// or lookups, so compilers vectorize the loop.
+void premultiplyAlpha(unsigned char* pixels, size_t pixelCount) {
+	for (size_t i = 0; i < pixelCount; ++i) {
+		unsigned char* pixel = pixels + i * 4;
+		unsigned int alpha = pixel[3];
+		for (int c = 0; c < 3; ++c) {
+			unsigned int value = pixel[c] * alpha + 128;
+			pixel[c] = static_cast<unsigned char>((value + (value >> 8)) >> 8);
+		}
+	}
+}
 
-	std::vector<unsigned char> resized(static_cast<size_t>(outWidth) * outHeight * channels);
-	if (outWidth == width && outHeight == height) {
-		std::copy(data, data + static_cast<size_t>(width) * height * channels, resized.begin());
+// Premultiplied to straight alpha, c * 255 / a rounded and clamped, through a table of 16.16
+// reciprocals instead of a division per channel. Fully transparent pixels become black.
+void unpremultiplyAlpha(unsigned char* pixels, size_t pixelCount) {
+	static const std::array<unsigned int, 256> reciprocals = [] {
+		std::array<unsigned int, 256> table = {};
+		for (unsigned int alpha = 1; alpha < 256; ++alpha) {
+			table[alpha] = (255u * 65536u + alpha / 2) / alpha;
+		}
+		return table;
+	}();
+	for (size_t i = 0; i < pixelCount; ++i) {
+		unsigned char* pixel = pixels + i * 4;
+		unsigned int reciprocal = reciprocals[pixel[3]];
+		for (int c = 0; c < 3; ++c) {
+			pixel[c] = static_cast<unsigned char>(std::min(255u, (pixel[c] * reciprocal + 32768u) >> 16));
+		}
+	}
+}
+
+void convertAlpha(unsigned char* pixels, size_t pixelCount, bool toPremultiplied) {
+	if (toPremultiplied) {
+		premultiplyAlpha(pixels, pixelCount);
 	} else {
-		stbir_pixel_layout layout = STBIR_RGBA;
-		if (!stbir_resize_uint8_linear(data, width, height, 0, resized.data(), outWidth, outHeight, 0, layout)) {
-			stbi_image_free(data);
-			return false;
+		unpremultiplyAlpha(pixels, pixelCount);
+	}
+}
+
+// Resized rows arrive one at a time from stb_image_resize2's output callback and are handed to the PNG
+// encoder a strip at a time, so no full-size output image is allocated unless a smaller tier is resized
+// from it (`keep`).
+struct StripSink {
+	PngStreamWriter* png = nullptr;
+	std::vector<unsigned char>* keep = nullptr;
+	std::vector<unsigned char> strip;
+	size_t rowBytes = 0;
+	int stripRows = 0;
+	int bufferedRows = 0;
+	int nextRow = 0;
+	bool inOrder = true;
+};
+
+void writeResizedScanline(void const* pixels, int numPixels, int y, void* context) {
+	StripSink* sink = static_cast<StripSink*>(context);
+	if (y != sink->nextRow++) {
+		sink->inOrder = false;
+		return;
+	}
+	std::memcpy(sink->strip.data() + sink->bufferedRows * sink->rowBytes, pixels, static_cast<size_t>(numPixels) * 4);
+	if (sink->keep) {
+		std::memcpy(sink->keep->data() + static_cast<size_t>(y) * sink->rowBytes, pixels, static_cast<size_t>(numPixels) * 4);
+	}
+	if (++sink->bufferedRows == sink->stripRows) {
+		sink->png->writeRows(sink->strip.data(), sink->bufferedRows, sink->rowBytes);
+		sink->bufferedRows = 0;
+	}
+}
+
+// How the scaled pages are encoded: compression level and threads per page.
+struct PngSettings {
+	PngLevel level = PngLevel::Default;
+	unsigned int threads = 1;
+};
+
+// One output resolution: pages are written to `dir` at `scale` times their downgraded size.
+struct OutputTier {
+	double scale = 1.0;
+	fs::path dir;
+};
+
+// Tiers as a suffix for log lines, when there is more than one.
+std::string tierLabel(const std::vector<OutputTier>& tiers, const OutputTier& tier) {
+	if (tiers.size() < 2) {
+		return "";
+	}
+	std::ostringstream label;
+	label << " (" << tier.scale << "x)";
+	return label.str();
+}
+
+// Writes an RGBA image resized to outWidth x outHeight. With `keep`, the written pixels are also
+// returned there.
+// Premultiplied pixels are resampled as they are; straight ones are premultiplied by the resizer for
+// the filter and unpremultiplied afterwards, so transparent texels bleed no color into edges either way.
+bool writeResizedImage(const unsigned char* pixels, int width, int height, const fs::path& outputPath, int outWidth, int outHeight,
+					   const PngSettings& settings, bool premultiplied, std::vector<unsigned char>* keep) {
+	const int channels = 4;
+	PngStreamWriter png(outputPath.string(), outWidth, outHeight, channels, settings.level, settings.threads);
+	if (!png.ok()) {
+		return false;
+	}
+	if (keep) {
+		keep->resize(static_cast<size_t>(outWidth) * outHeight * channels);
+	}
+	if (outWidth == width && outHeight == height) {
+		png.writeRows(pixels, height, static_cast<size_t>(width) * channels);
+		if (keep) {
+			std::memcpy(keep->data(), pixels, keep->size());
 		}
+		return png.finish();
 	}
 
-	stbi_image_free(data);
+	StripSink sink;
+	sink.png = &png;
+	sink.keep = keep;
+	sink.rowBytes = static_cast<size_t>(outWidth) * channels;
+	sink.stripRows = std::min(outHeight, stripHeight);
+	sink.strip.resize(sink.rowBytes * sink.stripRows);
+
+	STBIR_RESIZE resize;
+	stbir_resize_init(&resize, pixels, width, height, 0, nullptr, outWidth, outHeight, 0,
+					  premultiplied ? STBIR_RGBA_PM : STBIR_RGBA, STBIR_TYPE_UINT8);
+	stbir_set_pixel_callbacks(&resize, nullptr, writeResizedScanline);
+	stbir_set_user_data(&resize, &sink);
+	bool resized = stbir_resize_extended(&resize) != 0;
+	if (resized && sink.bufferedRows > 0) {
+		png.writeRows(sink.strip.data(), sink.bufferedRows, sink.rowBytes);
+	}
+	if (!resized || !sink.inOrder) {
+		return false;
+	}
+	return png.finish();
+}
 
-	const int stride = outWidth * channels;
-	return stbi_write_png(outputPath.string().c_str(), outWidth, outHeight, channels, resized.data(), stride) != 0;
+// Writes every tier of a decoded page, largest first. A tier is resized from the previous one when that
+// was downscaled from the page and is at least twice the tier's size, where the second pass adds no
+// visible softening and reads a quarter of the pixels or fewer; otherwise it is resized from the page.
+bool writeScaledTiers(const unsigned char* data, int width, int height, const std::vector<std::pair<fs::path, double>>& outputs,
+					  const PngSettings& settings, bool premultiplied) {
+	std::vector<unsigned char> previous;
+	std::vector<unsigned char> current;
+	int previousWidth = 0;
+	int previousHeight = 0;
+	bool success = true;
+	for (size_t i = 0; i < outputs.size() && success; ++i) {
+		double scaleFactor = outputs[i].second;
+		if (scaleFactor == 0.0) {
+			success = false;
+			break;
+		}
+		int outWidth = std::max(1, static_cast<int>(std::lround(static_cast<double>(width) / scaleFactor)));
+		int outHeight = std::max(1, static_cast<int>(std::lround(static_cast<double>(height) / scaleFactor)));
+
+		bool fromPrevious = !previous.empty() && previousWidth < width && previousWidth >= 2 * outWidth && previousHeight >= 2 * outHeight;
+		bool keep = i + 1 < outputs.size();
+		success = fromPrevious
+			? writeResizedImage(previous.data(), previousWidth, previousHeight, outputs[i].first, outWidth, outHeight, settings, premultiplied, keep ? &current : nullptr)
+			: writeResizedImage(data, width, height, outputs[i].first, outWidth, outHeight, settings, premultiplied, keep ? &current : nullptr);
+		if (keep) {
+			previous.swap(current);
+			previousWidth = outWidth;
+			previousHeight = outHeight;
+		}
+	}
+	return success;
 }
 
-bool scaleTextureImages(AtlasData& atlas, const fs::path& atlasDir, const fs::path& outputDir) {
+// One atlas of a batch: `atlas` is written per tier, `textureAtlas` has the page scales its textures
+// are resized with and `images` its repacked pages, if any, in page order.
+struct AtlasJob {
+	fs::path input;
+	fs::path atlasDir;
+	std::vector<OutputTier> tiers;
+	AtlasData atlas;
+	AtlasData textureAtlas;
+	std::vector<RgbaImage> images;
+};
+
+// A page of a batch and the log lines about it.
+struct BatchPage {
+	const AtlasJob* job = nullptr;
+	const AtlasPage* page = nullptr;
+	std::ostringstream log;
+	bool success = true;
+};
+
+// A page written to one tier. Outputs of the same source with equal `convert`, `premultiplied` and
+// `tierScale` are identical.
+struct TextureOutput {
+	BatchPage* page = nullptr;
+	const OutputTier* tier = nullptr;
+	fs::path path;
+	double tierScale = 1.0;
+	bool convert = false;  // the alpha is switched to `premultiplied` first
+	bool premultiplied = false;
+};
+
+// Everything written from one texture: a page file, shared by every page whose file has the same
+// content, or a repacked page.
+struct TextureSource {
+	fs::path path;
+	const RgbaImage* image = nullptr;
+	std::vector<TextureOutput> outputs;
+};
+
+void logOutput(const TextureOutput& output, const char* action, const std::string& suffix) {
+	output.page->log << "  [OK] " << action << ' ' << output.page->page->name << tierLabel(output.page->job->tiers, *output.tier)
+					 << suffix << '\n';
+}
+
+bool copyOutput(const fs::path& from, const TextureOutput& output) {
+	try {
+		fs::copy_file(from, output.path, fs::copy_options::overwrite_existing);
+		return true;
+	} catch (const fs::filesystem_error& copyError) {
+		output.page->log << "  [ERROR] Failed to copy " << output.page->page->name << ": " << copyError.what() << '\n';
+		output.page->success = false;
+		return false;
+	}
+}
+
+// Decodes the source at most once. Files at their own size and alpha are copied; the other outputs
+// are written a run of equal alpha handling at a time, all tiers of a run from the same pixels, and
+// outputs identical to one already written are copied from it. Runs converting the alpha come last,
+// so the pixels are converted in place once.
+void processTextureSource(TextureSource& source, const PngSettings& settings) {
+	std::vector<TextureOutput*> resized;
+	for (auto& output : source.outputs) {
+		if (source.image || output.convert || std::abs(output.tierScale - 1.0) >= 1e-6) {
+			resized.push_back(&output);
+		} else if (copyOutput(source.path, output)) {
+			logOutput(output, "Copied", " (scale≈1.0)");
+		}
+	}
+	std::stable_sort(resized.begin(), resized.end(), [](const TextureOutput* a, const TextureOutput* b) {
+		return std::make_tuple(a->convert, a->premultiplied, a->tierScale) < std::make_tuple(b->convert, b->premultiplied, b->tierScale);
+	});
+
+	std::unique_ptr<stbi_uc, void (*)(void*)> decoded(nullptr, stbi_image_free);
+	int width = source.image ? source.image->width : 0;
+	int height = source.image ? source.image->height : 0;
+	bool converted = false;
+	for (size_t begin = 0, end = 0; begin < resized.size(); begin = end) {
+		const TextureOutput& first = *resized[begin];
+		while (end < resized.size() && resized[end]->convert == first.convert && resized[end]->premultiplied == first.premultiplied) {
+			++end;
+		}
+		auto fail = [&](const std::string& reason) {
+			for (size_t i = begin; i < end; ++i) {
+				resized[i]->page->log << "  [ERROR] Failed to process " << resized[i]->page->page->name << reason << '\n';
+				resized[i]->page->success = false;
+			}
+		};
+
+		const unsigned char* pixels = source.image ? source.image->pixels.data() : decoded.get();
+		if (!pixels) {
+			int channels = 0;
+			decoded.reset(stbi_load(source.path.string().c_str(), &width, &height, &channels, STBI_rgb_alpha));
+			if (!decoded) {
+				const char* reason = stbi_failure_reason();
+				fail(": stb_image failed to load '" + source.path.string() + "': " + (reason ? reason : "unknown error"));
+				return;
+			}
+			pixels = decoded.get();
+		}
+		if (first.convert && !converted) {
+			convertAlpha(decoded.get(), static_cast<size_t>(width) * height, first.premultiplied);
+			converted = true;
+		}
+
+		std::vector<std::pair<fs::path, double>> tiers;
+		std::vector<const TextureOutput*> written(end - begin);
+		for (size_t i = begin; i < end; ++i) {
+			if (tiers.empty() || resized[i]->tierScale != tiers.back().second) {
+				tiers.emplace_back(resized[i]->path, resized[i]->tierScale);
+				written[i - begin] = resized[i];
+			} else {
+				written[i - begin] = written[i - begin - 1];
+			}
+		}
+		if (!writeScaledTiers(pixels, width, height, tiers, settings, first.premultiplied)) {
+			fail("");
+			continue;
+		}
+		std::string suffix = first.convert ? (first.premultiplied ? " (premultiplied)" : " (unpremultiplied)") : "";
+		for (size_t i = begin; i < end; ++i) {
+			const TextureOutput& output = *resized[i];
+			const TextureOutput& original = *written[i - begin];
+			if (&original == &output) {
+				logOutput(output, source.image ? "Wrote" : "Scaled", suffix);
+			} else if (copyOutput(original.path, output)) {
+				logOutput(output, "Copied", " (same as " + original.path.string() + ")");
+			}
+		}
+	}
+}
+
+// Writes the textures of every atlas in the batch, each texture on its own thread of one pool. Page
+// files are decoded once per distinct content, found by size and hash and confirmed byte for byte,
+// however many pages and atlases use them. `alpha` is the output alpha mode (true for premultiplied),
+// or empty to keep each page's; repacked pages are expected to be in it already.
+bool scaleTextureImages(const std::vector<AtlasJob>& batch, unsigned int jobs, PngLevel level, std::optional<bool> alpha) {
 	std::cout << "Processing texture images:" << std::endl;
+	std::vector<BatchPage> pages;
+	for (const auto& job : batch) {
+		for (const auto& page : job.textureAtlas.pages) {
+			pages.emplace_back();
+			pages.back().job = &job;
+			pages.back().page = &page;
+		}
+	}
+
+	std::vector<TextureSource> sources;
+	std::map<fs::path, size_t> fileSources;
+	std::vector<size_t> pageSources(pages.size(), SIZE_MAX);
+	for (size_t i = 0, pageIndex = 0; i < batch.size(); ++i) {
+		for (size_t p = 0; p < batch[i].textureAtlas.pages.size(); ++p, ++pageIndex) {
+			BatchPage& page = pages[pageIndex];
+			fs::path inputPath = (batch[i].atlasDir / fs::path(page.page->name)).lexically_normal();
+			std::string extension = fs::path(page.page->name).extension().string();
+			if (p < batch[i].images.size()) {
+				pageSources[pageIndex] = sources.size();
+				sources.emplace_back();
+				sources.back().image = &batch[i].images[p];
+			} else if (!fs::exists(inputPath)) {
+				page.log << "  [WARN] Texture file not found: " << inputPath.string() << '\n';
+				page.success = false;
+			} else if (extension != ".png" && extension != ".PNG") {
+				page.log << "  [ERROR] Unsupported texture format for " << page.page->name
+						 << ". Only .png textures are currently supported." << '\n';
+				page.success = false;
+			} else if (page.page->scale <= 0.0) {
+				page.log << "  [ERROR] Invalid scale value " << page.page->scale << " for " << page.page->name << '\n';
+				page.success = false;
+			} else {
+				auto [it, added] = fileSources.emplace(inputPath, sources.size());
+				if (added) {
+					sources.emplace_back();
+					sources.back().path = inputPath;
+				}
+				pageSources[pageIndex] = it->second;
+			}
+		}
+	}
+
+	// Files with the same content are merged into the first of them.
+	std::vector<size_t> fileIndexes;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		if (!sources[i].image) {
+			fileIndexes.push_back(i);
+		}
+	}
+	std::vector<std::pair<size_t, size_t>> keys(fileIndexes.size());
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+	parallelFor(fileIndexes.size(), jobs != 0 ? jobs : cores, [&](size_t i) {
+		MappedFile file(sources[fileIndexes[i]].path);
+		keys[i] = { file.view().size(), std::hash<std::string_view>()(file.view()) };
+	});
+	std::vector<size_t> mergedInto(sources.size());
+	for (size_t i = 0; i < sources.size(); ++i) {
+		mergedInto[i] = i;
+	}
+	std::map<std::pair<size_t, size_t>, std::vector<size_t>> byContent;
+	for (size_t i = 0; i < fileIndexes.size(); ++i) {
+		size_t index = fileIndexes[i];
+		if (keys[i].first == 0) {
+			continue;
+		}
+		auto& candidates = byContent[keys[i]];
+		MappedFile file(sources[index].path);
+		for (size_t candidate : candidates) {
+			if (MappedFile(sources[candidate].path).view() == file.view()) {
+				mergedInto[index] = candidate;
+				break;
+			}
+		}
+		if (mergedInto[index] == index) {
+			candidates.push_back(index);
+		}
+	}
+
+	// Outputs, one per page and tier. A path written twice must get the same pixels both times.
+	std::map<fs::path, std::tuple<size_t, bool, bool, double>> claimed;
+	for (size_t i = 0; i < pages.size(); ++i) {
+		if (pageSources[i] == SIZE_MAX) {
+			continue;
+		}
+		BatchPage& page = pages[i];
+		size_t sourceIndex = mergedInto[pageSources[i]];
+		TextureSource& source = sources[sourceIndex];
+		for (const auto& tier : page.job->tiers) {
+			TextureOutput output;
+			output.page = &page;
+			output.tier = &tier;
+			output.path = (tier.dir / fs::path(page.page->name)).lexically_normal();
+			output.tierScale = page.page->scale / tier.scale;
+			output.convert = !source.image && alpha && *alpha != page.page->pma;
+			output.premultiplied = alpha ? *alpha : page.page->pma;
+
+			auto content = std::make_tuple(sourceIndex, output.convert, output.premultiplied, output.tierScale);
+			auto [it, added] = claimed.emplace(output.path, content);
+			if (!added) {
+				if (it->second == content) {
+					logOutput(output, "Shared", " with an earlier atlas");
+				} else {
+					page.log << "  [WARN] " << output.path.string() << " is written from another texture already; skipped" << '\n';
+					page.success = false;
+				}
+				continue;
+			}
+			std::error_code ec;
+			fs::create_directories(output.path.parent_path(), ec);
+			if (ec) {
+				page.log << "  [ERROR] Failed to create directory for " << output.path.string() << ": " << ec.message() << '\n';
+				page.success = false;
+				continue;
+			}
+			source.outputs.push_back(output);
+		}
+	}
+	sources.erase(std::remove_if(sources.begin(), sources.end(), [](const TextureSource& source) { return source.outputs.empty(); }),
+				  sources.end());
+
+	if (jobs == 0) {
+		jobs = cores;
+	}
+	jobs = std::min<unsigned int>(jobs, std::max<size_t>(1, sources.size()));
+	// Cores left over when there are fewer textures than cores go to encoding each texture.
+	PngSettings settings;
+	settings.level = level;
+	settings.threads = std::max(1u, cores / jobs);
+	parallelFor(sources.size(), jobs, [&](size_t i) { processTextureSource(sources[i], settings); });
+
 	bool overallSuccess = true;
+	const AtlasJob* job = nullptr;
+	for (const auto& page : pages) {
+		if (batch.size() > 1 && page.job != job) {
+			job = page.job;
+			std::cout << "  " << job->input.string() << ":" << std::endl;
+		}
+		std::cout << page.log.str() << std::flush;
+		overallSuccess = overallSuccess && page.success;
+	}
+	return overallSuccess;
+}
 
+// Drops regions whose names are not in `referenced` (sorted), then pages left without regions.
+void pruneAtlas(AtlasData& atlas, const std::vector<std::string>& referenced) {
+	std::cout << "Pruning regions:" << std::endl;
+	size_t total = 0;
+	size_t kept = 0;
+	std::vector<std::string> found;
 	for (auto& page : atlas.pages) {
-		fs::path originalPath(page.name);
-		fs::path inputPath = atlasDir / originalPath;
-		if (!fs::exists(inputPath)) {
-			std::cout << "  [WARN] Texture file not found: " << inputPath.string() << std::endl;
-			overallSuccess = false;
-			continue;
+		total += page.regions.size();
+		page.regions.erase(std::remove_if(page.regions.begin(), page.regions.end(), [&](const AtlasRegion& region) {
+			return !std::binary_search(referenced.begin(), referenced.end(), region.name);
+		}), page.regions.end());
+		kept += page.regions.size();
+		for (const auto& region : page.regions) {
+			found.push_back(region.name);
 		}
+	}
+	size_t pages = atlas.pages.size();
+	atlas.pages.erase(std::remove_if(atlas.pages.begin(), atlas.pages.end(), [](const AtlasPage& page) {
+		return page.regions.empty();
+	}), atlas.pages.end());
+	std::cout << "  [OK] Kept " << kept << " of " << total << " regions on " << atlas.pages.size() << " of " << pages << " page(s)" << std::endl;
+
+	std::sort(found.begin(), found.end());
+	std::vector<std::string> missing;
+	std::set_difference(referenced.begin(), referenced.end(), found.begin(), found.end(), std::back_inserter(missing));
+	if (!missing.empty()) {
+		std::cout << "  [WARN] " << missing.size() << " referenced region(s) not in the atlas, e.g. " << missing.front() << std::endl;
+	}
+}
+
+// Page limits are in pixels of the largest output tier: pages are resized by outputScale, and unless
+// the page scale is kept (4.x output) also by 1 / page scale.
+struct RepackOptions {
+	bool enabled = false;
+	bool trim = false;
+	PackSettings pack;
+	double outputScale = 1.0;
+	bool keepPageScale = false;
+};
+
+// Pack settings in a group's own pixels. Power-of-two pages stay power-of-two in the output only when
+// the group's resize factor is a power of two itself.
+PackSettings packSettingsForGroup(const RepackOptions& options, const AtlasPage& group) {
+	double pageScale = group.scale > 0.0 ? group.scale : 1.0;
+	double factor = options.keepPageScale ? options.outputScale : options.outputScale / pageScale;
+	PackSettings settings = options.pack;
+	settings.maxWidth = std::max(1, static_cast<int>(std::floor(options.pack.maxWidth / factor + 1e-6)));
+	settings.maxHeight = std::max(1, static_cast<int>(std::floor(options.pack.maxHeight / factor + 1e-6)));
+	settings.padding = static_cast<int>(std::ceil(options.pack.padding / factor - 1e-6));
+	if (settings.powerOfTwo) {
+		double exponent = std::log2(factor);
+		if (std::abs(exponent - std::round(exponent)) > 1e-6) {
+			std::cout << "  [WARN] Pages of scale " << pageScale << " are power-of-two before resizing only" << std::endl;
+		}
+	}
+	return settings;
+}
 
-		if (originalPath.extension().string() != ".png" && originalPath.extension().string() != ".PNG") {
-			std::cout << "  [ERROR] Unsupported texture format for " << originalPath.string()
-					  << ". Only .png textures are currently supported." << std::endl;
-			overallSuccess = false;
+// Copies a region out of its page, turned back to its unrotated orientation. A region rotated by 90
+// degrees has its top edge along the left of its bounds, running upwards.
+RgbaImage extractRegion(const unsigned char* page, int pageWidth, int pageHeight, const AtlasRegion& region) {
+	RgbaImage image;
+	image.width = std::max(0, region.width);
+	image.height = std::max(0, region.height);
+	image.pixels.assign(static_cast<size_t>(image.width) * image.height * 4, 0);
+	for (int iy = 0; iy < image.height; ++iy) {
+		for (int ix = 0; ix < image.width; ++ix) {
+			int px = region.x + ix;
+			int py = region.y + iy;
+			if (region.degrees == 90) {
+				px = region.x + iy;
+				py = region.y + image.width - 1 - ix;
+			} else if (region.degrees == 180) {
+				px = region.x + image.width - 1 - ix;
+				py = region.y + image.height - 1 - iy;
+			} else if (region.degrees == 270) {
+				px = region.x + image.height - 1 - iy;
+				py = region.y + ix;
+			}
+			if (px < 0 || py < 0 || px >= pageWidth || py >= pageHeight) {
+				continue;
+			}
+			std::memcpy(&image.pixels[(static_cast<size_t>(iy) * image.width + ix) * 4],
+						&page[(static_cast<size_t>(py) * pageWidth + px) * 4], 4);
+		}
+	}
+	return image;
+}
+
+// Crops fully transparent borders and moves them into the region's offsets (offsetY counts from the
+// bottom). Nine-patch regions keep their borders, which their splits are measured from.
+void trimRegion(RgbaImage& image, AtlasRegion& region) {
+	if (!region.splits.empty() || image.width == 0 || image.height == 0) {
+		return;
+	}
+	if (region.originalWidth == 0 && region.originalHeight == 0) {
+		region.originalWidth = region.width;
+		region.originalHeight = region.height;
+	}
+	int left = image.width;
+	int right = -1;
+	int top = image.height;
+	int bottom = -1;
+	for (int y = 0; y < image.height; ++y) {
+		const unsigned char* row = &image.pixels[static_cast<size_t>(y) * image.width * 4];
+		for (int x = 0; x < image.width; ++x) {
+			if (row[x * 4 + 3] != 0) {
+				left = std::min(left, x);
+				right = std::max(right, x);
+				top = std::min(top, y);
+				bottom = std::max(bottom, y);
+			}
+		}
+	}
+	if (right < 0) {
+		// Nothing visible: keep a single transparent pixel.
+		left = right = top = bottom = 0;
+	}
+	int width = right - left + 1;
+	int height = bottom - top + 1;
+	if (width == image.width && height == image.height) {
+		return;
+	}
+	std::vector<unsigned char> cropped(static_cast<size_t>(width) * height * 4);
+	for (int y = 0; y < height; ++y) {
+		std::memcpy(&cropped[static_cast<size_t>(y) * width * 4],
+					&image.pixels[(static_cast<size_t>(top + y) * image.width + left) * 4], static_cast<size_t>(width) * 4);
+	}
+	region.offsetX += left;
+	region.offsetY += image.height - 1 - bottom;
+	region.width = width;
+	region.height = height;
+	image.width = width;
+	image.height = height;
+	image.pixels.swap(cropped);
+}
+
+// Alpha of every region in its original image, taken from the repacked pages in `images` or else
+// from the decoded page files. A name repeated with several indexes keeps its first region.
+bool collectRegionAlpha(const AtlasData& atlas, const fs::path& atlasDir, const std::vector<RgbaImage>& images, unsigned int jobs,
+						std::map<std::string, RegionAlpha>& regions) {
+	std::vector<std::vector<std::pair<std::string, RegionAlpha>>> pageRegions(atlas.pages.size());
+	std::vector<std::ostringstream> logs(atlas.pages.size());
+	std::vector<char> results(atlas.pages.size(), 0);
+	parallelFor(atlas.pages.size(), jobs, [&](size_t i) {
+		const AtlasPage& page = atlas.pages[i];
+		RgbaImage decoded;
+		const RgbaImage* image = i < images.size() ? &images[i] : nullptr;
+		if (!image) {
+			fs::path inputPath = atlasDir / fs::path(page.name);
+			int channels = 0;
+			stbi_uc* data = stbi_load(inputPath.string().c_str(), &decoded.width, &decoded.height, &channels, STBI_rgb_alpha);
+			if (!data) {
+				const char* reason = stbi_failure_reason();
+				logs[i] << "  [ERROR] Failed to load '" << inputPath.string() << "': " << (reason ? reason : "unknown error") << '\n';
+				return;
+			}
+			decoded.pixels.assign(data, data + static_cast<size_t>(decoded.width) * decoded.height * 4);
+			stbi_image_free(data);
+			image = &decoded;
+		}
+		for (const auto& region : page.regions) {
+			RgbaImage pixels = extractRegion(image->pixels.data(), image->width, image->height, region);
+			RegionAlpha alpha;
+			alpha.originalWidth = region.originalWidth != 0 ? region.originalWidth : region.width;
+			alpha.originalHeight = region.originalHeight != 0 ? region.originalHeight : region.height;
+			alpha.left = region.offsetX;
+			alpha.top = alpha.originalHeight - region.offsetY - region.height;
+			alpha.width = pixels.width;
+			alpha.height = pixels.height;
+			alpha.alpha.resize(static_cast<size_t>(pixels.width) * pixels.height);
+			for (size_t p = 0; p < alpha.alpha.size(); ++p) {
+				alpha.alpha[p] = pixels.pixels[p * 4 + 3];
+			}
+			pageRegions[i].emplace_back(region.name, std::move(alpha));
+		}
+		results[i] = 1;
+	});
+	bool loaded = true;
+	for (size_t i = 0; i < atlas.pages.size(); ++i) {
+		std::cout << logs[i].str() << std::flush;
+		loaded = loaded && results[i];
+		for (auto& [name, alpha] : pageRegions[i]) {
+			regions.emplace(name, std::move(alpha));
+		}
+	}
+	return loaded;
+}
+
+bool samePageSettings(const AtlasPage& a, const AtlasPage& b) {
+	return a.format == b.format && a.minFilter == b.minFilter && a.magFilter == b.magFilter &&
+		a.repeat == b.repeat && a.pma == b.pma && a.scale == b.scale;
+}
+
+// Replaces the atlas pages with new ones holding every region bin-packed, and returns their pixels in
+// `images`. Regions are only packed together when their pages share format, filter, repeat, pma and
+// scale. New pages are named <pageStem>.png, <pageStem>_2.png, ...
+bool repackAtlas(AtlasData& atlas, const fs::path& atlasDir, const std::string& pageStem, const RepackOptions& options,
+				 unsigned int jobs, std::vector<RgbaImage>& images) {
+	std::cout << "Repacking regions:" << std::endl;
+	struct LooseRegion {
+		AtlasRegion region;
+		RgbaImage image;
+		size_t group = 0;
+	};
+	std::vector<std::vector<LooseRegion>> pageRegions(atlas.pages.size());
+	std::vector<std::ostringstream> logs(atlas.pages.size());
+	std::vector<char> results(atlas.pages.size(), 0);
+	parallelFor(atlas.pages.size(), jobs, [&](size_t i) {
+		const AtlasPage& page = atlas.pages[i];
+		fs::path inputPath = atlasDir / fs::path(page.name);
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		stbi_uc* data = stbi_load(inputPath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (!data) {
+			const char* reason = stbi_failure_reason();
+			logs[i] << "  [ERROR] Failed to load '" << inputPath.string() << "': " << (reason ? reason : "unknown error") << '\n';
+			return;
+		}
+		for (const auto& region : page.regions) {
+			LooseRegion loose;
+			loose.region = region;
+			loose.image = extractRegion(data, width, height, region);
+			if (options.trim) {
+				trimRegion(loose.image, loose.region);
+			}
+			loose.region.degrees = 0;
+			pageRegions[i].push_back(std::move(loose));
+		}
+		stbi_image_free(data);
+		results[i] = 1;
+	});
+	bool loaded = true;
+	for (size_t i = 0; i < atlas.pages.size(); ++i) {
+		std::cout << logs[i].str() << std::flush;
+		loaded = loaded && results[i];
+	}
+	if (!loaded) {
+		return false;
+	}
+
+	std::vector<AtlasPage> groups;
+	std::vector<std::vector<LooseRegion>> groupRegions;
+	long long oldArea = 0;
+	for (size_t i = 0; i < atlas.pages.size(); ++i) {
+		const AtlasPage& page = atlas.pages[i];
+		oldArea += static_cast<long long>(page.width) * page.height;
+		size_t group = 0;
+		while (group < groups.size() && !samePageSettings(groups[group], page)) {
+			++group;
+		}
+		if (group == groups.size()) {
+			groups.push_back(page);
+			groups.back().regions.clear();
+			groupRegions.emplace_back();
+		}
+		for (auto& loose : pageRegions[i]) {
+			groupRegions[group].push_back(std::move(loose));
+		}
+	}
+
+	AtlasData packed;
+	images.clear();
+	long long newArea = 0;
+	size_t regionCount = 0;
+	for (size_t group = 0; group < groups.size(); ++group) {
+		std::vector<LooseRegion>& regions = groupRegions[group];
+		if (regions.empty()) {
 			continue;
 		}
+		std::vector<std::pair<int, int>> sizes;
+		for (const auto& loose : regions) {
+			sizes.emplace_back(loose.region.width, loose.region.height);
+		}
+		std::vector<PackPlacement> placements;
+		std::vector<PackedPage> pages = packRects(sizes, packSettingsForGroup(options, groups[group]), placements);
+		if (pages.empty()) {
+			std::cerr << "Error: A region does not fit on a " << options.pack.maxWidth << "x" << options.pack.maxHeight << " page." << std::endl;
+			return false;
+		}
 
-		fs::path outputPath = outputDir / originalPath;
+		size_t firstPage = packed.pages.size();
+		for (const auto& size : pages) {
+			size_t number = packed.pages.size() + 1;
+			AtlasPage page = groups[group];
+			page.name = pageStem + (number > 1 ? "_" + std::to_string(number) : "") + ".png";
+			page.width = size.width;
+			page.height = size.height;
+			packed.pages.push_back(page);
+			RgbaImage image;
+			image.width = size.width;
+			image.height = size.height;
+			image.pixels.assign(static_cast<size_t>(size.width) * size.height * 4, 0);
+			images.push_back(std::move(image));
+			newArea += static_cast<long long>(size.width) * size.height;
+		}
 
-		fs::path outputParent = outputPath.parent_path();
-		std::error_code ec;
-		if (!outputParent.empty()) {
-			fs::create_directories(outputParent, ec);
+		for (size_t r = 0; r < regions.size(); ++r) {
+			AtlasRegion region = regions[r].region;
+			const RgbaImage& source = regions[r].image;
+			const PackPlacement& placement = placements[r];
+			size_t pageIndex = firstPage + placement.page;
+			region.x = placement.x;
+			region.y = placement.y;
+			region.degrees = placement.rotated ? 90 : 0;
+			RgbaImage& target = images[pageIndex];
+			for (int iy = 0; iy < source.height; ++iy) {
+				for (int ix = 0; ix < source.width; ++ix) {
+					int px = placement.rotated ? region.x + iy : region.x + ix;
+					int py = placement.rotated ? region.y + source.width - 1 - ix : region.y + iy;
+					std::memcpy(&target.pixels[(static_cast<size_t>(py) * target.width + px) * 4],
+								&source.pixels[(static_cast<size_t>(iy) * source.width + ix) * 4], 4);
+				}
+			}
+			packed.pages[pageIndex].regions.push_back(region);
+			++regionCount;
+		}
+	}
+	std::cout << "  [OK] " << regionCount << " regions on " << packed.pages.size() << " page(s), "
+			  << oldArea << " -> " << newArea << " pixels" << std::endl;
+	atlas = std::move(packed);
+	return true;
+}
+
+// The atlas of one tier: page scales divided by the tier's, so writeAtlasData3x rescales every
+// coordinate for it.
+AtlasData atlasForTier(const AtlasData& atlas, double tierScale) {
+	AtlasData tierAtlas = atlas;
+	for (auto& page : tierAtlas.pages) {
+		page.scale = (page.scale != 0.0 ? page.scale : 1.0) / tierScale;
+	}
+	return tierAtlas;
+}
+
+// Page and region coordinates multiplied by `factor`, rounded as in writeAtlasData3x, for a 4.x atlas
+// whose page scale stays a declared value.
+AtlasData scaleAtlasData(const AtlasData& atlas, double factor) {
+	AtlasData scaled = atlas;
+	if (factor == 1.0) {
+		return scaled;
+	}
+	double divisor = 1.0 / factor;
+	for (auto& page : scaled.pages) {
+		page.width = roundScaled(page.width, divisor);
+		page.height = roundScaled(page.height, divisor);
+		page.scale = (page.scale != 0.0 ? page.scale : 1.0) * factor;
+		for (auto& region : page.regions) {
+			for (int* value : { &region.x, &region.y, &region.width, &region.height, &region.offsetX, &region.offsetY,
+								&region.originalWidth, &region.originalHeight }) {
+				*value = roundScaled(*value, divisor);
+			}
+			for (int& value : region.splits) {
+				value = roundScaled(value, divisor);
+			}
+			for (int& value : region.pads) {
+				value = roundScaled(value, divisor);
+			}
+		}
+	}
+	return scaled;
+}
+
+// Comma separated, positive and distinct scales, returned largest first.
+bool parseScales(const std::string& text, std::vector<double>& scales) {
+	std::vector<std::string_view> values;
+	splitValues(text, values);
+	scales.clear();
+	for (std::string_view entry : values) {
+		double value = 0.0;
+		if (!parseDouble(entry, value) || !(value > 0.0)) {
+			return false;
+		}
+		scales.push_back(value);
+	}
+	std::sort(scales.begin(), scales.end(), std::greater<double>());
+	return !scales.empty() && std::adjacent_find(scales.begin(), scales.end()) == scales.end();
+}
+
+// Settings shared by every atlas of a run.
+struct ConvertOptions {
+	unsigned int jobs = 0;
+	PngLevel pngLevel = PngLevel::Default;
+	std::vector<double> scales = { 1.0 };
+	bool atlas4x = false;
+	RepackOptions repack;
+	std::vector<std::string> skeletonFiles;
+	bool tightMeshes = false;
+	TightMeshSettings meshSettings;
+	std::optional<bool> alpha;
+};
+
+// Reads one atlas and does everything up to its textures: pruning, repacking, fitting meshes and
+// converting repacked pages. Its files go to `outputDir` / `subdir`, or to a tier directory under it.
+bool prepareAtlas(const fs::path& inputAtlas, const fs::path& outputDir, const fs::path& subdir, const ConvertOptions& options,
+				  AtlasJob& job) {
+	job.input = inputAtlas;
+	for (double scale : options.scales) {
+		OutputTier tier;
+		tier.scale = scale;
+		tier.dir = outputDir;
+		if (options.scales.size() > 1) {
+			std::ostringstream name;
+			name << scale << 'x';
+			tier.dir /= name.str();
+		}
+		if (!subdir.empty()) {
+			tier.dir /= subdir;
 		}
+		job.tiers.push_back(tier);
+	}
+
+	for (const auto& tier : job.tiers) {
+		std::error_code ec;
+		fs::create_directories(tier.dir, ec);
 		if (ec) {
-			std::cout << "  [ERROR] Failed to create directory for " << outputPath.string() << ": " << ec.message() << std::endl;
-			overallSuccess = false;
-			continue;
+			std::cerr << "Error: Failed to create output directory: " << tier.dir.string() << std::endl;
+			return false;
 		}
+	}
 
-		double scale = page.scale;
-		if (scale <= 0.0) {
-			std::cout << "  [ERROR] Invalid scale value " << scale << " for " << originalPath.string() << std::endl;
-			overallSuccess = false;
-			continue;
+	std::cout << "Converting Spine atlas: " << inputAtlas.filename().string() << std::endl;
+	std::cout << "Output directory: " << (subdir.empty() ? outputDir : outputDir / subdir).string() << std::endl;
+	std::cout << "--------------------------------------------------" << std::endl;
+
+	AtlasData& atlasData = job.atlas;
+	{
+		MappedFile atlasFile(inputAtlas);
+		if (!atlasFile.ok()) {
+			std::cerr << "Error: Failed to read atlas file." << std::endl;
+			return false;
 		}
+		std::string parseError;
+		atlasData = readAtlasData(atlasFile.view(), &parseError);
+		if (!parseError.empty()) {
+			std::cout << "[WARN] " << inputAtlas.filename().string() << ", " << parseError << std::endl;
+		}
+	}
+	job.atlasDir = inputAtlas.parent_path();
+	if (job.atlasDir.empty()) {
+		job.atlasDir = fs::current_path();
+	}
+	const fs::path& atlasDir = job.atlasDir;
+	// 2.x atlases do not store page sizes; the textures have them.
+	for (auto& page : atlasData.pages) {
+		int channels = 0;
+		if ((page.width == 0 || page.height == 0) &&
+			!stbi_info((atlasDir / fs::path(page.name)).string().c_str(), &page.width, &page.height, &channels)) {
+			std::cout << "[WARN] No size for page " << page.name << std::endl;
+		}
+	}
 
-		bool needsScaling = std::abs(scale - 1.0) >= 1e-6;
-		if (!needsScaling) {
+	std::vector<SkeletonData> skeletons;
+	if (!options.skeletonFiles.empty()) {
+		std::vector<std::string> referenced;
+		for (const auto& file : options.skeletonFiles) {
 			try {
-				fs::copy_file(inputPath, outputPath, fs::copy_options::overwrite_existing);
-				std::cout << "  [OK] Copied " << originalPath.string() << " (scale≈1.0)" << std::endl;
-			} catch (const fs::filesystem_error& copyError) {
-				std::cout << "  [ERROR] Failed to copy " << originalPath.string() << ": " << copyError.what() << std::endl;
-				overallSuccess = false;
+				skeletons.push_back(readSkeletonFile(file));
+			} catch (const std::exception& e) {
+				std::cerr << "Error: Failed to read skeleton " << file << ": " << e.what() << std::endl;
+				return false;
 			}
-			continue;
+			std::vector<std::string> regions = referencedRegions(skeletons.back());
+			referenced.insert(referenced.end(), regions.begin(), regions.end());
 		}
+		std::sort(referenced.begin(), referenced.end());
+		referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+		pruneAtlas(atlasData, referenced);
+	}
 
-		if (!scaleImageWithStb(inputPath, outputPath, scale)) {
-			std::cout << "  [ERROR] Failed to process " << originalPath.string() << std::endl;
-			overallSuccess = false;
-		} else {
-			std::cout << "  [OK] Scaled " << originalPath.string() << std::endl;
+	unsigned int jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+	if (options.repack.enabled) {
+		RepackOptions repack = options.repack;
+		repack.outputScale = options.scales.front();
+		repack.keepPageScale = options.atlas4x;
+		if (!repackAtlas(atlasData, atlasDir, inputAtlas.stem().string(), repack, jobs, job.images)) {
+			std::cerr << "Error: Failed to repack the atlas." << std::endl;
+			return false;
 		}
 	}
 
-	return overallSuccess;
+	// Meshes are fitted to the final regions, so trimming and repacking cannot move pixels out of them.
+	if (options.tightMeshes) {
+		std::cout << "Fitting meshes to regions:" << std::endl;
+		std::map<std::string, RegionAlpha> regionAlpha;
+		if (!collectRegionAlpha(atlasData, atlasDir, job.images, jobs, regionAlpha)) {
+			std::cerr << "Error: Failed to read the atlas pages." << std::endl;
+			return false;
+		}
+		for (size_t i = 0; i < skeletons.size(); ++i) {
+			TightMeshStats stats = tightenRegionAttachments(skeletons[i], regionAlpha, options.meshSettings);
+			fs::path outputPath = outputDir / fs::path(options.skeletonFiles[i]).filename();
+			try {
+				writeSkeletonFile(skeletons[i], outputPath.string(), detectSpineVersion(options.skeletonFiles[i]));
+			} catch (const std::exception& e) {
+				std::cerr << "Error: Failed to write skeleton " << outputPath.string() << ": " << e.what() << std::endl;
+				return false;
+			}
+			std::cout << "  [OK] " << outputPath.filename().string() << ": " << stats.converted << " region attachment(s) to meshes, "
+					  << static_cast<long long>(stats.areaBefore) << " -> " << static_cast<long long>(stats.areaAfter) << " pixels; "
+					  << stats.unchanged << " unchanged" << std::endl;
+			if (stats.missing > 0) {
+				std::cout << "  [WARN] " << stats.missing << " region attachment(s) without a region in the atlas" << std::endl;
+			}
+		}
+	}
+
+	// A 4.x atlas keeps the page scale as a declared value, so its textures only change per tier.
+	job.textureAtlas = atlasData;
+	if (options.atlas4x) {
+		for (auto& page : job.textureAtlas.pages) {
+			page.scale = 1.0;
+		}
+	}
+	// Repacked pages are converted here; page files as they are decoded.
+	if (options.alpha) {
+		parallelFor(job.images.size(), jobs, [&](size_t i) {
+			if (job.textureAtlas.pages[i].pma != *options.alpha) {
+				convertAlpha(job.images[i].pixels.data(), job.images[i].pixels.size() / 4, *options.alpha);
+			}
+		});
+		for (auto& page : atlasData.pages) {
+			page.pma = *options.alpha;
+		}
+	}
+	return true;
+}
+
+// The atlases to convert, each with the directory under the output directory it goes to: a directory
+// argument contributes every .atlas file below it, at its path relative to the directory.
+bool collectAtlases(const std::vector<std::string>& inputs, std::vector<std::pair<fs::path, fs::path>>& atlases) {
+	for (const auto& input : inputs) {
+		fs::path path = input;
+		if (!fs::is_directory(path)) {
+			if (!fs::exists(path)) {
+				std::cerr << "Error: Input atlas file not found: " << path.string() << std::endl;
+				return false;
+			}
+			atlases.emplace_back(path, fs::path());
+			continue;
+		}
+		std::vector<fs::path> found;
+		std::error_code ec;
+		for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+			if (it->is_regular_file() && it->path().extension() == ".atlas") {
+				found.push_back(it->path());
+			}
+		}
+		if (ec) {
+			std::cerr << "Error: Failed to list " << path.string() << ": " << ec.message() << std::endl;
+			return false;
+		}
+		std::sort(found.begin(), found.end());
+		for (const auto& atlas : found) {
+			fs::path subdir = atlas.parent_path().lexically_relative(path);
+			atlases.emplace_back(atlas, subdir == "." ? fs::path() : subdir);
+		}
+	}
+	return true;
 }
 
 void printUsage(const char* programName) {
-	std::cout << "Usage: " << programName << " <input_atlas> <output_dir>" << std::endl;
+	std::cout << "Usage: " << programName << " <input_atlas|input_dir>... <output_dir> [options]" << std::endl;
+	std::cout << "  Several atlases share one thread pool and decode each distinct texture once; a directory" << std::endl;
+	std::cout << "  stands for every .atlas file below it, written to the same relative path." << std::endl;
+	std::cout << "  -j, --jobs <n>         Number of texture pages processed in parallel (default: all cores)" << std::endl;
+	std::cout << "  --png-level <level>    PNG compression: fast, default or max (default: default)" << std::endl;
+	std::cout << "  --scales <list>        Output tiers, e.g. 1,0.5,0.25; each tier goes to <output_dir>/<scale>x" << std::endl;
+	std::cout << "  --atlas-4x             Write a 4.x atlas, keeping the page scale, instead of a 3.x one" << std::endl;
+	std::cout << "  --alpha <mode>         Convert the pages to pma (premultiplied) or straight alpha" << std::endl;
+	std::cout << "  --skeleton <file>      Keep only regions this skeleton's attachments use (repeatable)" << std::endl;
+	std::cout << "  --tight-meshes         Turn the skeletons' region attachments into meshes hugging their visible pixels," << std::endl;
+	std::cout << "                         written to <output_dir>" << std::endl;
+	std::cout << "  --max-vertices <n>     With --tight-meshes, vertices per mesh (default: 8)" << std::endl;
+	std::cout << "  --repack               Bin-pack all regions into new pages" << std::endl;
+	std::cout << "  --trim                 With --repack, crop transparent region borders" << std::endl;
+	std::cout << "  --max-size <n>         With --repack, maximum output page width and height (default: 2048)" << std::endl;
+	std::cout << "  --pot                  With --repack, power-of-two page sizes" << std::endl;
+	std::cout << "  --padding <n>          With --repack, pixels between regions (default: 2)" << std::endl;
+	std::cout << "  --no-rotate            With --repack, never rotate regions" << std::endl;
 }
 
 } // namespace
 
 int main(int argc, char* argv[]) {
-	if (argc != 3) {
+	std::vector<std::string> positional;
+	ConvertOptions options;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "-j" || arg == "--jobs") {
+			int value = 0;
+			if (i + 1 < argc && parseInt(argv[++i], value) && value > 0) {
+				options.jobs = static_cast<unsigned int>(value);
+			} else {
+				std::cerr << "Error: " << arg << " requires a positive number" << std::endl;
+				return 1;
+			}
+		} else if (arg == "--png-level") {
+			std::string value = i + 1 < argc ? argv[++i] : "";
+			if (value == "fast") {
+				options.pngLevel = PngLevel::Fast;
+			} else if (value == "default") {
+				options.pngLevel = PngLevel::Default;
+			} else if (value == "max") {
+				options.pngLevel = PngLevel::Max;
+			} else {
+				std::cerr << "Error: --png-level must be fast, default or max" << std::endl;
+				return 1;
+			}
+		} else if (arg == "--atlas-4x") {
+			options.atlas4x = true;
+		} else if (arg == "--alpha") {
+			std::string value = i + 1 < argc ? argv[++i] : "";
+			if (value == "pma") {
+				options.alpha = true;
+			} else if (value == "straight") {
+				options.alpha = false;
+			} else {
+				std::cerr << "Error: --alpha must be pma or straight" << std::endl;
+				return 1;
+			}
+		} else if (arg == "--skeleton") {
+			if (i + 1 >= argc) {
+				std::cerr << "Error: --skeleton requires a file" << std::endl;
+				return 1;
+			}
+			options.skeletonFiles.push_back(argv[++i]);
+		} else if (arg == "--tight-meshes") {
+			options.tightMeshes = true;
+		} else if (arg == "--max-vertices") {
+			int value = 0;
+			if (i + 1 < argc && parseInt(argv[++i], value) && value >= 3) {
+				options.meshSettings.maxVertices = value;
+			} else {
+				std::cerr << "Error: --max-vertices requires a number of at least 3" << std::endl;
+				return 1;
+			}
+		} else if (arg == "--repack") {
+			options.repack.enabled = true;
+		} else if (arg == "--trim") {
+			options.repack.trim = true;
+		} else if (arg == "--pot") {
+			options.repack.pack.powerOfTwo = true;
+		} else if (arg == "--no-rotate") {
+			options.repack.pack.allowRotation = false;
+		} else if (arg == "--max-size" || arg == "--padding") {
+			int value = 0;
+			bool valid = i + 1 < argc && parseInt(argv[++i], value) && (arg == "--padding" ? value >= 0 : value > 0);
+			if (!valid) {
+				std::cerr << "Error: " << arg << " requires a " << (arg == "--padding" ? "non-negative" : "positive") << " number" << std::endl;
+				return 1;
+			}
+			if (arg == "--padding") {
+				options.repack.pack.padding = value;
+			} else {
+				options.repack.pack.maxWidth = value;
+				options.repack.pack.maxHeight = value;
+			}
+		} else if (arg == "--scales") {
+			if (i + 1 >= argc || !parseScales(argv[++i], options.scales)) {
+				std::cerr << "Error: --scales requires distinct positive numbers separated by commas" << std::endl;
+				return 1;
+			}
+		} else {
+			positional.push_back(arg);
+		}
+	}
+	if (positional.size() < 2) {
 		printUsage(argv[0]);
 		return 1;
 	}
-
-	fs::path inputAtlas = argv[1];
-	fs::path outputDir = argv[2];
-
-	if (!fs::exists(inputAtlas)) {
-		std::cerr << "Error: Input atlas file not found: " << inputAtlas.string() << std::endl;
+	if (options.tightMeshes && options.skeletonFiles.empty()) {
+		std::cerr << "Error: --tight-meshes requires --skeleton" << std::endl;
 		return 1;
 	}
 
-	std::error_code ec;
-	fs::create_directories(outputDir, ec);
-	if (ec) {
-		std::cerr << "Error: Failed to create output directory: " << outputDir.string() << std::endl;
+	fs::path outputDir = positional.back();
+	positional.pop_back();
+	std::vector<std::pair<fs::path, fs::path>> atlases;
+	if (!collectAtlases(positional, atlases)) {
 		return 1;
 	}
-
-	std::cout << "Converting Spine 4.x atlas: " << inputAtlas.filename().string() << std::endl;
-	std::cout << "Output directory: " << outputDir.string() << std::endl;
-	std::cout << "--------------------------------------------------" << std::endl;
-
-	std::string atlasContent;
-	if (!readFile(inputAtlas, atlasContent)) {
-		std::cerr << "Error: Failed to read atlas file." << std::endl;
+	if (atlases.empty()) {
+		std::cerr << "Error: No .atlas files found" << std::endl;
 		return 1;
 	}
-
-	AtlasData atlasData = readAtlasData4x(atlasContent);
-	fs::path atlasDir = inputAtlas.parent_path();
-	if (atlasDir.empty()) {
-		atlasDir = fs::current_path();
+	if (atlases.size() > 1 && !options.skeletonFiles.empty()) {
+		std::cerr << "Error: --skeleton only works with a single atlas" << std::endl;
+		return 1;
+	}
+	std::map<fs::path, fs::path> atlasOutputs;
+	for (const auto& [input, subdir] : atlases) {
+		fs::path outputPath = (subdir / input.filename()).lexically_normal();
+		auto [it, added] = atlasOutputs.emplace(outputPath, input);
+		if (!added) {
+			std::cerr << "Error: " << it->second.string() << " and " << input.string() << " would both be written to "
+					  << outputPath.string() << std::endl;
+			return 1;
+		}
 	}
 
-	bool textureSuccess = scaleTextureImages(atlasData, atlasDir, outputDir);
-
-	std::string atlas3xContent = writeAtlasData3x(atlasData);
-	fs::path outputAtlasPath = outputDir / inputAtlas.filename();
-	if (!writeFile(outputAtlasPath, atlas3xContent)) {
-		std::cerr << "Error: Failed to write converted atlas file." << std::endl;
-		return 1;
+	std::vector<AtlasJob> batch(atlases.size());
+	for (size_t i = 0; i < atlases.size(); ++i) {
+		if (!prepareAtlas(atlases[i].first, outputDir, atlases[i].second, options, batch[i])) {
+			return 1;
+		}
+	}
+	bool textureSuccess = scaleTextureImages(batch, options.jobs, options.pngLevel, options.alpha);
+
+	for (const auto& job : batch) {
+		for (const auto& tier : job.tiers) {
+			std::string outputContent = options.atlas4x ? writeAtlasData4x(scaleAtlasData(job.atlas, tier.scale))
+														: writeAtlasData3x(atlasForTier(job.atlas, tier.scale));
+			fs::path outputAtlasPath = tier.dir / job.input.filename();
+			if (!writeFile(outputAtlasPath, outputContent)) {
+				std::cerr << "Error: Failed to write converted atlas file." << std::endl;
+				return 1;
+			}
+			std::cout << "[OK] Atlas file converted: " << outputAtlasPath.string() << std::endl;
+		}
 	}
-	std::cout << "[OK] Atlas file converted: " << outputAtlasPath.string() << std::endl;
 
 	std::cout << "--------------------------------------------------" << std::endl;
 	if (textureSuccess) {
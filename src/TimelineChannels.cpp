@@ -0,0 +1,180 @@
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::vector<CurveChannelSpec> valueChannels(size_t count, ChannelUnit unit) {
+    static const CurveChannel channels[] = { CurveChannel::V1, CurveChannel::V2, CurveChannel::V3, CurveChannel::V4, CurveChannel::V5, CurveChannel::V6 };
+    std::vector<CurveChannelSpec> specs;
+    for (size_t i = 0; i < count; ++i) specs.push_back({ channels[i], unit });
+    return specs;
+}
+
+std::vector<CurveChannelSpec> colorChannels(std::initializer_list<CurveChannel> channels) {
+    std::vector<CurveChannelSpec> specs;
+    for (CurveChannel channel : channels) specs.push_back({ channel, ChannelUnit::Color });
+    return specs;
+}
+
+std::optional<std::vector<CurveChannelSpec>> slotChannels(const std::string& timelineType) {
+    using C = CurveChannel;
+    if (timelineType == "rgba") return colorChannels({ C::R1, C::G1, C::B1, C::A1 });
+    if (timelineType == "rgb") return colorChannels({ C::R1, C::G1, C::B1 });
+    if (timelineType == "rgba2") return colorChannels({ C::R1, C::G1, C::B1, C::A1, C::R2, C::G2, C::B2 });
+    if (timelineType == "rgb2") return colorChannels({ C::R1, C::G1, C::B1, C::R2, C::G2, C::B2 });
+    if (timelineType == "alpha") return valueChannels(1, ChannelUnit::Color);
+    return std::nullopt;
+}
+
+std::vector<CurveChannelSpec> boneChannels(const std::string& timelineType) {
+    if (timelineType == "rotate") return valueChannels(1, ChannelUnit::Rotation);
+    if (timelineType == "translate") return valueChannels(2, ChannelUnit::Length);
+    if (timelineType == "translatex" || timelineType == "translatey") return valueChannels(1, ChannelUnit::Length);
+    if (timelineType == "scale") return valueChannels(2, ChannelUnit::Ratio);
+    if (timelineType == "scalex" || timelineType == "scaley") return valueChannels(1, ChannelUnit::Ratio);
+    if (timelineType == "shear") return valueChannels(2, ChannelUnit::Angle);
+    if (timelineType == "shearx" || timelineType == "sheary") return valueChannels(1, ChannelUnit::Angle);
+    return {};
+}
+
+std::vector<CurveChannelSpec> pathChannels(const SkeletonData& skeleton, const std::string& pathName, const std::string& timelineType) {
+    if (timelineType == "mix") return valueChannels(3, ChannelUnit::Ratio);
+    for (const auto& path : skeleton.pathConstraints) {
+        if (path.name != pathName) continue;
+        bool percent = timelineType == "position"
+            ? path.positionMode == PositionMode_Percent
+            : path.spacingMode == SpacingMode_Percent || path.spacingMode == SpacingMode_Proportional;
+        return valueChannels(1, percent ? ChannelUnit::Ratio : ChannelUnit::Length);
+    }
+    return valueChannels(1, ChannelUnit::Length);
+}
+
+std::vector<CurveChannelSpec> physicsChannels(const std::string& timelineType) {
+    if (timelineType == "strength" || timelineType == "wind" || timelineType == "gravity") return valueChannels(1, ChannelUnit::Scalar);
+    return valueChannels(1, ChannelUnit::Ratio);
+}
+
+unsigned char toColorByte(float value) {
+    return static_cast<unsigned char>(std::clamp(std::lround(value * 255.0f), 0L, 255L));
+}
+
+const Attachment* findAttachment(const SkeletonData& skeleton, const std::string& skinName, const std::string& slotName, const std::string& attachmentName) {
+    for (const auto& skin : skeleton.skins) {
+        if (skin.name != skinName) continue;
+        auto slotIt = skin.attachments.find(slotName);
+        if (slotIt == skin.attachments.end()) return nullptr;
+        auto attachmentIt = slotIt->second.find(attachmentName);
+        return attachmentIt == slotIt->second.end() ? nullptr : &attachmentIt->second;
+    }
+    return nullptr;
+}
+
+// Deform timelines keyed on a linked mesh animate its parent's vertices.
+const Attachment* resolveVertexOwner(const SkeletonData& skeleton, const std::string& skinName, const std::string& slotName, const std::string& attachmentName) {
+    const Attachment* attachment = findAttachment(skeleton, skinName, slotName, attachmentName);
+    if (attachment && attachment->type == AttachmentType_Linkedmesh) {
+        const auto& linked = std::get<LinkedmeshAttachment>(attachment->data);
+        return findAttachment(skeleton, linked.skin.value_or("default"), slotName, linked.parentMesh);
+    }
+    return attachment;
+}
+
+}
+
+float normalizeRotationDelta(float delta) {
+    delta = std::fmod(delta, 360.0f);
+    if (delta > 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return delta;
+}
+
+bool uses4xCurves(const SkeletonData& skeleton) {
+    return !skeleton.version || skeleton.version->empty() || (*skeleton.version)[0] >= '4';
+}
+
+float getCurveChannel(const TimelineFrame& frame, CurveChannel channel) {
+    Color color1 = frame.color1.value_or(Color());
+    Color color2 = frame.color2.value_or(Color());
+    switch (channel) {
+        case CurveChannel::R1: return color1.r / 255.0f;
+        case CurveChannel::G1: return color1.g / 255.0f;
+        case CurveChannel::B1: return color1.b / 255.0f;
+        case CurveChannel::A1: return color1.a / 255.0f;
+        case CurveChannel::R2: return color2.r / 255.0f;
+        case CurveChannel::G2: return color2.g / 255.0f;
+        case CurveChannel::B2: return color2.b / 255.0f;
+        case CurveChannel::V1: return frame.value1;
+        case CurveChannel::V2: return frame.value2;
+        case CurveChannel::V3: return frame.value3;
+        case CurveChannel::V4: return frame.value4;
+        case CurveChannel::V5: return frame.value5;
+        case CurveChannel::V6: return frame.value6;
+    }
+    return 0.0f;
+}
+
+void setCurveChannel(TimelineFrame& frame, CurveChannel channel, float value) {
+    switch (channel) {
+        case CurveChannel::R1: frame.color1 = frame.color1.value_or(Color()); frame.color1->r = toColorByte(value); break;
+        case CurveChannel::G1: frame.color1 = frame.color1.value_or(Color()); frame.color1->g = toColorByte(value); break;
+        case CurveChannel::B1: frame.color1 = frame.color1.value_or(Color()); frame.color1->b = toColorByte(value); break;
+        case CurveChannel::A1: frame.color1 = frame.color1.value_or(Color()); frame.color1->a = toColorByte(value); break;
+        case CurveChannel::R2: frame.color2 = frame.color2.value_or(Color()); frame.color2->r = toColorByte(value); break;
+        case CurveChannel::G2: frame.color2 = frame.color2.value_or(Color()); frame.color2->g = toColorByte(value); break;
+        case CurveChannel::B2: frame.color2 = frame.color2.value_or(Color()); frame.color2->b = toColorByte(value); break;
+        case CurveChannel::V1: frame.value1 = value; break;
+        case CurveChannel::V2: frame.value2 = value; break;
+        case CurveChannel::V3: frame.value3 = value; break;
+        case CurveChannel::V4: frame.value4 = value; break;
+        case CurveChannel::V5: frame.value5 = value; break;
+        case CurveChannel::V6: frame.value6 = value; break;
+    }
+}
+
+void forEachCurveTimeline(SkeletonData& skeleton, const std::function<void(Timeline&, const std::vector<CurveChannelSpec>&)>& visit) {
+    for (auto& animation : skeleton.animations) {
+        for (auto& [slotName, multiTimeline] : animation.slots)
+            for (auto& [timelineType, timeline] : multiTimeline)
+                if (auto channels = slotChannels(timelineType))
+                    visit(timeline, *channels);
+        for (auto& [boneName, multiTimeline] : animation.bones)
+            for (auto& [timelineType, timeline] : multiTimeline)
+                visit(timeline, boneChannels(timelineType));
+        for (auto& [ikName, timeline] : animation.ik)
+            visit(timeline, { {CurveChannel::V1, ChannelUnit::Ratio}, {CurveChannel::V2, ChannelUnit::Length} });
+        for (auto& [transformName, timeline] : animation.transform)
+            visit(timeline, valueChannels(6, ChannelUnit::Ratio));
+        for (auto& [pathName, multiTimeline] : animation.path)
+            for (auto& [timelineType, timeline] : multiTimeline)
+                visit(timeline, pathChannels(skeleton, pathName, timelineType));
+        for (auto& [physicsName, multiTimeline] : animation.physics)
+            for (auto& [timelineType, timeline] : multiTimeline)
+                if (timelineType != "reset")
+                    visit(timeline, physicsChannels(timelineType));
+    }
+}
+
+void forEachDeformTimeline(SkeletonData& skeleton, const std::function<void(Timeline&)>& visit) {
+    for (auto& animation : skeleton.animations)
+        for (auto& [skinName, skin] : animation.attachments)
+            for (auto& [slotName, slot] : skin)
+                for (auto& [attachmentName, multiTimeline] : slot)
+                    for (auto& [timelineType, timeline] : multiTimeline)
+                        if (timelineType == "deform")
+                            visit(timeline);
+}
+
+std::map<const Attachment*, std::vector<Timeline*>> collectDeformTimelines(SkeletonData& skeleton) {
+    std::map<const Attachment*, std::vector<Timeline*>> deforms;
+    for (auto& animation : skeleton.animations)
+        for (auto& [skinName, skin] : animation.attachments)
+            for (auto& [slotName, slot] : skin)
+                for (auto& [attachmentName, multiTimeline] : slot) {
+                    auto deformIt = multiTimeline.find("deform");
+                    if (deformIt == multiTimeline.end()) continue;
+                    if (const Attachment* owner = resolveVertexOwner(skeleton, skinName, slotName, attachmentName))
+                        deforms[owner].push_back(&deformIt->second);
+                }
+    return deforms;
+}
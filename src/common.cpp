@@ -110,6 +110,32 @@ OptStr readStringRef(DataInput* input, SkeletonData* skeletonData) {
     else return skeletonData->strings[index - 1]; 
 }
 
+void skipBytes(DataInput* input, size_t count) {
+    if (count > (size_t)(input->end - input->cursor)) throw std::runtime_error("Unexpected end of skeleton data");
+    input->cursor += count; 
+}
+
+void skipString(DataInput* input) {
+    int length = readVarint(input, true); 
+    if (length > 1) skipBytes(input, length - 1); 
+}
+
+void skipCurveTimeline3x(DataInput* input, int frameCount, size_t frameSize) {
+    for (int frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+        skipBytes(input, frameSize); 
+        if (frameIndex < frameCount - 1 && readByte(input) == CURVE_BEZIER) skipBytes(input, 16); 
+    }
+}
+
+void skipCurveTimeline4x(DataInput* input, int frameCount, size_t frameSize, int channels) {
+    readVarint(input, true); 
+    skipBytes(input, frameSize); 
+    for (int frameIndex = 1; frameIndex < frameCount; frameIndex++) {
+        skipBytes(input, frameSize); 
+        if (readSByte(input) == CURVE_BEZIER) skipBytes(input, channels * 16); 
+    }
+}
+
 // binary writer
 
 void writeByte(Binary& binary, unsigned char value) {
@@ -3,427 +3,374 @@
 #include <string>
 #include <vector>
 #include <filesystem>
-#include <regex>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <map>
+#include <cctype>
 
 #include "SkeletonData.h"
 
-enum class SpineVersion {
-    Version35 = 0,
-    Version36 = 1,
-    Version37 = 2,
-    Version38 = 3,
-    Version40 = 4,
-    Version41 = 5,
-    Version42 = 6,
-    Invalid = -1
-};
-
-enum class FileFormat {
-    Json,
-    Skel,
-    Unknown
-};
-
-struct ConversionOptions {
+struct ConversionOptions : ConversionSettings {
     std::string inputFile;
     std::string outputFile;
-    FileFormat inputFormat = FileFormat::Unknown;
-    FileFormat outputFormat = FileFormat::Unknown;
-    SpineVersion outputVersion = SpineVersion::Invalid;
-    std::string outputVersionString; // 完整的版本号字符串，如 "4.2.11"
     bool help = false;
-    bool removeCurve = false;
 };
 
-bool aboveOrEqualVersion(SpineVersion version, SpineVersion target) {
-    return static_cast<int>(version) >= static_cast<int>(target);
+bool writeBinaryFile(const std::string& path, const Binary& data) {
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) {
+        std::cerr << "Error: Cannot create output file: " << path << "\n";
+        return false;
+    }
+    ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return true;
 }
 
-bool belowOrEqualVersion(SpineVersion version, SpineVersion target) {
-    return static_cast<int>(version) <= static_cast<int>(target);
+Binary readBinaryFile(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) throw std::runtime_error("Cannot open input file: " + path);
+    return Binary((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
 }
 
-SpineVersion detectSpineVersion(const std::string& filePath) {
-    try {
-        std::ifstream ifs(filePath, std::ios::binary);
-        if (!ifs) return SpineVersion::Invalid;
-        
-        const size_t headerSize = 256;
-        char buffer[headerSize] = {0};
-        ifs.read(buffer, headerSize);
-        std::string data(buffer, ifs.gcount());
-        
-        // Use regex to find version pattern x.x.x
-        std::regex versionRegex(R"((\d+)\.(\d+)\.(\d+))");
-        std::smatch match;
-        
-        if (std::regex_search(data, match, versionRegex)) {
-            std::string majorVersion = match[1].str();
-            std::string minorVersion = match[2].str();
-            std::string majorMinor = majorVersion + "." + minorVersion;
-            
-            if (majorMinor == "3.5") {
-                return SpineVersion::Version35;
-            } else if (majorMinor == "3.6") {
-                return SpineVersion::Version36;
-            } else if (majorMinor == "3.7") {
-                return SpineVersion::Version37;
-            } else if (majorMinor == "3.8") {
-                return SpineVersion::Version38;
-            } else if (majorMinor == "4.0") {
-                return SpineVersion::Version40;
-            } else if (majorMinor == "4.1") {
-                return SpineVersion::Version41;
-            } else if (majorMinor == "4.2") {
-                return SpineVersion::Version42;
-            }
+bool writeTextFile(const std::string& path, const std::string& text) {
+    std::ofstream ofs(path);
+    if (!ofs) {
+        std::cerr << "Error: Cannot create output file: " << path << "\n";
+        return false;
+    }
+    ofs << text;
+    return true;
+}
+
+// <stem>.<group><ext> next to the base file, with characters unsafe in file names replaced.
+std::string shardFileName(const std::string& baseFile, const std::string& groupName) {
+    std::string safeName = groupName;
+    for (char& c : safeName) {
+        if (std::string("/\\:*?\"<>|").find(c) != std::string::npos) c = '_';
+    }
+    std::filesystem::path path(baseFile);
+    return (path.parent_path() / (path.stem().string() + "." + safeName + path.extension().string())).string();
+}
+
+// Writes the converted skeleton, then its shards next to it and its index.
+bool writeOutputs(const ConversionOptions& options, const ConversionResult& result) {
+    auto write = [&](const std::string& path, const Binary& data) {
+        return options.outputFormat == FileFormat::Skel ? writeBinaryFile(path, data) : writeTextFile(path, std::string(data.begin(), data.end()));
+    };
+    // Names differing only in unsafe characters or case would end up in the same file.
+    std::map<std::string, std::string> shardNames;
+    for (const auto& [name, shard] : result.shards) {
+        std::string key = shardFileName(options.outputFile, name);
+        std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        auto [it, inserted] = shardNames.emplace(key, name);
+        if (!inserted) {
+            std::cerr << "Error: Shards '" << it->second << "' and '" << name << "' would both be written to "
+                      << shardFileName(options.outputFile, name) << "\n";
+            return false;
         }
     }
-    catch (...) {
-        std::cerr << "Error: Failed to read file: " << filePath << "\n";
+    if (!write(options.outputFile, result.output)) return false;
+    for (const auto& [name, shard] : result.shards) {
+        std::string shardFile = shardFileName(options.outputFile, name);
+        if (!write(shardFile, shard)) return false;
+        std::cout << "Shard file: " << shardFile << "\n";
     }
-    
-    return SpineVersion::Invalid;
+    if (!result.index.empty()) {
+        std::string indexFile = options.outputFile + ".index.json";
+        std::ofstream ofs(indexFile);
+        if (!ofs) {
+            std::cerr << "Error: Cannot create index file: " << indexFile << "\n";
+            return false;
+        }
+        ofs << result.index;
+        std::cout << "Index file: " << indexFile << "\n";
+    }
+    return true;
 }
 
-std::string getVersionString(SpineVersion version) {
-    switch (version) {
-        case SpineVersion::Version35: return "3.5";
-        case SpineVersion::Version36: return "3.6";
-        case SpineVersion::Version37: return "3.7";
-        case SpineVersion::Version38: return "3.8";
-        case SpineVersion::Version40: return "4.0";
-        case SpineVersion::Version41: return "4.1";
-        case SpineVersion::Version42: return "4.2";
-        default: return "Unknown";
+struct DiffOptions {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    DiffTolerance tolerance;
+    unsigned int jobs = 0;
+    bool summaryOnly = false;
+    bool valid = true;
+};
+
+struct DiffResult {
+    std::vector<SkeletonDiff> diffs;
+    std::string error;
+};
+
+// Same pairing rule as tools/json_diff_all.py: <base><suffix1> is matched with <base><suffix2>
+// in the same directory, and a plain ".json" suffix skips derived ".skel.json" files.
+std::vector<std::pair<std::string, std::string>> findFilePairs(const std::string& directory, const std::string& suffix1, const std::string& suffix2) {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    auto endsWith = [](const std::string& str, const std::string& suffix) {
+        return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+        if (!entry.is_regular_file()) continue;
+        std::string filename = entry.path().filename().string();
+        if (!endsWith(filename, suffix1)) continue;
+        if (suffix1 == ".json" && (endsWith(filename, ".skel.json") || endsWith(filename, ".atlas.json") || endsWith(filename, ".png.json"))) continue;
+        std::filesystem::path other = entry.path().parent_path() / (filename.substr(0, filename.size() - suffix1.size()) + suffix2);
+        if (std::filesystem::exists(other)) pairs.emplace_back(entry.path().string(), other.string());
     }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
 }
 
-SpineVersion parseVersionString(const std::string& versionStr) {
-    // 强制要求完整的三段式版本号 (x.y.z)
-    std::regex versionRegex(R"(^(\d+)\.(\d+)\.(\d+)$)");
-    std::smatch match;
-    
-    if (std::regex_match(versionStr, match, versionRegex)) {
-        std::string majorVersion = match[1].str();
-        std::string minorVersion = match[2].str();
-        std::string majorMinor = majorVersion + "." + minorVersion;
-        
-        if (majorMinor == "3.5") return SpineVersion::Version35;
-        else if (majorMinor == "3.6") return SpineVersion::Version36;
-        else if (majorMinor == "3.7") return SpineVersion::Version37;
-        else if (majorMinor == "3.8") return SpineVersion::Version38;
-        else if (majorMinor == "4.0") return SpineVersion::Version40;
-        else if (majorMinor == "4.1") return SpineVersion::Version41;
-        else if (majorMinor == "4.2") return SpineVersion::Version42;
+void printDiff(size_t index, const SkeletonDiff& diff) {
+    std::cout << "  " << index << ". Path: " << diff.path << "\n";
+    switch (diff.type) {
+        case DiffType::Diff_Number:
+            std::cout << "     Number mismatch (tolerance " << diff.tolerance << "): " << diff.value1 << " vs " << diff.value2
+                      << " (abs " << diff.difference << ", rel " << diff.relativeDifference * 100.0 << "%)\n";
+            break;
+        case DiffType::Diff_Value:
+            std::cout << "     Value mismatch: " << diff.value1 << " vs " << diff.value2 << "\n";
+            break;
+        case DiffType::Diff_Length:
+            std::cout << "     Length mismatch: " << diff.value1 << " vs " << diff.value2 << "\n";
+            break;
+        case DiffType::Diff_MissingInFirst:
+            std::cout << "     Only in file 2\n";
+            break;
+        case DiffType::Diff_MissingInSecond:
+            std::cout << "     Only in file 1\n";
+            break;
     }
-    
-    return SpineVersion::Invalid;
 }
 
-bool convertFile(const std::string& inputFile, const std::string& outputFile, 
-                FileFormat inputFormat, FileFormat outputFormat, 
-                SpineVersion inputVersion, SpineVersion outputVersion, 
-                const std::string& outputVersionString,
-                bool removeCurveOption) {
-    
-    try {
-        // Read input file
-        std::vector<unsigned char> binaryData;
-        Json jsonData;
-        
-        if (inputFormat == FileFormat::Skel) {
-            std::ifstream ifs(inputFile, std::ios::binary);
-            if (!ifs) {
-                std::cerr << "Error: Cannot open input file: " << inputFile << "\n";
-                return false;
-            }
-            binaryData.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-        } else if (inputFormat == FileFormat::Json) {
-            std::ifstream ifs(inputFile);
-            if (!ifs) {
-                std::cerr << "Error: Cannot open input file: " << inputFile << "\n";
-                return false;
-            }
-            ifs >> jsonData;
-        }
-        
-        // Read data using input version
-        SkeletonData skelData;
-        switch (inputVersion) {
-            case SpineVersion::Version35: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine35::readBinaryData(binaryData);
-                } else {
-                    skelData = spine35::readJsonData(jsonData);
-                }
-                break;
-            }
-            case SpineVersion::Version36: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine36::readBinaryData(binaryData);
-                } else {
-                    skelData = spine36::readJsonData(jsonData);
-                }
-                break;
-            }
-            case SpineVersion::Version37: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine37::readBinaryData(binaryData);
-                } else {
-                    skelData = spine37::readJsonData(jsonData);
-                }
-                break;
-            }
-            case SpineVersion::Version38: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine38::readBinaryData(binaryData);
-                } else {
-                    skelData = spine38::readJsonData(jsonData);
-                }
-                break;
-            }
-            case SpineVersion::Version40: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine40::readBinaryData(binaryData);
-                } else {
-                    skelData = spine40::readJsonData(jsonData);
-                }
-                break;
-            }
-            case SpineVersion::Version41: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine41::readBinaryData(binaryData);
-                } else {
-                    skelData = spine41::readJsonData(jsonData);
-                }
-                break;
-            }
-            case SpineVersion::Version42: {
-                if (inputFormat == FileFormat::Skel) {
-                    skelData = spine42::readBinaryData(binaryData);
-                } else {
-                    skelData = spine42::readJsonData(jsonData);
-                }
-                break;
-            }
-            default:
-                std::cerr << "Error: Unsupported input Spine version\n";
-                return false;
-        }
-        
-        // 如果指定了输出版本字符串，则设置版本号
-        if (!outputVersionString.empty()) {
-            skelData.version = outputVersionString;
-        }
-        
-        // 跨版本转换处理
-        if (aboveOrEqualVersion(inputVersion, SpineVersion::Version40) &&
-            belowOrEqualVersion(outputVersion, SpineVersion::Version38)) {
-            std::cout << "Converting 4.x proportional path spacing mode to length for 3.x...\n";
-            convertSpacingMode4xTo3x(skelData);
-            std::cout << "Converting Spine 4.x rotate timelines to 3.x-compatible shortest-path keys...\n";
-            convertRotateTimeline4xTo3x(skelData);
-            if (removeCurveOption) {
-                std::cout << "Converting from 4.x to 3.x with --remove-curve, stripping curves...\n";
-                removeCurve(skelData);
-            } else {
-                std::cout << "Converting from 4.x to 3.x, adjusting curve format from abs to rel...\n"; 
-                convertCurve4xTo3x(skelData);
+int runDiff(const DiffOptions& options) {
+    unsigned int jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<unsigned int>(jobs, std::max<size_t>(1, options.pairs.size()));
+    std::cout << "Comparing " << options.pairs.size() << " file pair(s) with " << jobs << " thread(s)...\n";
+    std::cout << "------------------------------------------------------------\n";
+
+    std::vector<DiffResult> results(options.pairs.size());
+    std::atomic<size_t> next = 0;
+    auto worker = [&]() {
+        for (size_t i = next++; i < options.pairs.size(); i = next++) {
+            try {
+                SkeletonData a = readSkeletonFile(options.pairs[i].first);
+                SkeletonData b = readSkeletonFile(options.pairs[i].second);
+                results[i].diffs = diffSkeletonData(a, b, options.tolerance);
+            } catch (const std::exception& e) {
+                results[i].error = e.what();
             }
         }
-        if (belowOrEqualVersion(inputVersion, SpineVersion::Version38) &&
-            aboveOrEqualVersion(outputVersion, SpineVersion::Version40)) {
-            std::cout << "Converting Spine 3.x rotate timelines to 4.x-compatible absolute angles...\n";
-            convertRotateTimeline3xTo4x(skelData);
-            if (removeCurveOption) {
-                std::cout << "Converting from 3.x to 4.x with --remove-curve, stripping curves...\n";
-                removeCurve(skelData);
-            } else {
-                std::cout << "Converting from 3.x to 4.x, adjusting curve format from rel to abs...\n"; 
-                convertCurve3xTo4x(skelData);
-            }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < jobs; i++) threads.emplace_back(worker);
+    for (auto& thread : threads) thread.join();
+
+    size_t same = 0, different = 0, errors = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& [file1, file2] = options.pairs[i];
+        const DiffResult& result = results[i];
+        if (!result.error.empty()) {
+            errors++;
+            std::cout << "[ERROR] " << file1 << " <-> " << file2 << ": " << result.error << "\n";
+        } else if (result.diffs.empty()) {
+            same++;
+            if (!options.summaryOnly) std::cout << "[SAME] " << file1 << " <-> " << file2 << "\n";
+        } else {
+            different++;
+            std::cout << "[DIFF] " << file1 << " <-> " << file2 << ": " << result.diffs.size() << " difference(s)\n";
+            if (!options.summaryOnly)
+                for (size_t j = 0; j < result.diffs.size(); j++) printDiff(j + 1, result.diffs[j]);
         }
-        if (aboveOrEqualVersion(inputVersion, SpineVersion::Version42) &&
-            belowOrEqualVersion(outputVersion, SpineVersion::Version41)) {
-            std::cout << "Converting from 4.2 to below 4.2, adjusting constraint order...\n"; 
-            convertOrder42ToBelow(skelData);
+    }
+
+    std::cout << "------------------------------------------------------------\n";
+    std::cout << "Total pairs: " << results.size() << ", same: " << same << ", different: " << different << ", errors: " << errors << "\n";
+    return different == 0 && errors == 0 ? 0 : 1;
+}
+
+// Shard files written next to <base> by --split: <stem>.*<ext>. Merging restores the original animation order.
+std::vector<std::string> findShardFiles(const std::string& baseFile, const std::string& outputFile) {
+    std::filesystem::path basePath(baseFile);
+    std::string prefix = basePath.stem().string() + ".";
+    std::string ext = basePath.extension().string();
+    std::filesystem::path directory = basePath.parent_path().empty() ? std::filesystem::path(".") : basePath.parent_path();
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (!entry.is_regular_file()) continue;
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + ext.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - ext.size(), ext.size(), ext) != 0) continue;
+        if (std::filesystem::exists(outputFile) && std::filesystem::equivalent(entry.path(), outputFile)) continue;
+        files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+int runMerge(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Error: --merge requires <base> <output> [<shard> ...]\n";
+        return 1;
+    }
+    std::string baseFile = argv[2];
+    std::string outputFile = argv[3];
+    std::vector<std::string> shardFiles(argv + 4, argv + argc);
+    try {
+        FileFormat format = detectFileFormat(baseFile);
+        if (format == FileFormat::Unknown || detectFileFormat(outputFile) != format) {
+            throw std::runtime_error("Base and output must both be .skel or both be .json");
         }
-        
-        // Write data using output version
-        switch (outputVersion) {
-            case SpineVersion::Version35: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine35::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine35::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            case SpineVersion::Version36: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine36::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine36::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            case SpineVersion::Version37: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine37::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine37::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            case SpineVersion::Version38: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine38::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine38::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            case SpineVersion::Version40: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine40::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine40::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            case SpineVersion::Version41: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine41::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine41::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            case SpineVersion::Version42: {
-                if (outputFormat == FileFormat::Skel) {
-                    auto outputData = spine42::writeBinaryData(skelData);
-                    std::ofstream ofs(outputFile, std::ios::binary);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs.write(reinterpret_cast<const char*>(outputData.data()), outputData.size());
-                } else {
-                    auto outputJson = spine42::writeJsonData(skelData);
-                    std::ofstream ofs(outputFile);
-                    if (!ofs) {
-                        std::cerr << "Error: Cannot create output file: " << outputFile << "\n";
-                        return false;
-                    }
-                    ofs << dumpJson(outputJson);
-                }
-                break;
-            }
-            default:
-                std::cerr << "Error: Unsupported output Spine version\n";
-                return false;
+        SkeletonData base = readSkeletonFile(baseFile);
+        if (!base.animations.empty()) throw std::runtime_error("Base skeleton already has animations: " + baseFile);
+        if (shardFiles.empty()) shardFiles = findShardFiles(baseFile, outputFile);
+        if (shardFiles.empty()) throw std::runtime_error("No shard files found next to " + baseFile);
+
+        for (const auto& shardFile : shardFiles) std::cout << "Shard file: " << shardFile << "\n";
+        if (format == FileFormat::Skel) {
+            std::vector<Binary> shards;
+            for (const auto& shardFile : shardFiles) shards.push_back(readBinaryFile(shardFile));
+            if (!writeBinaryFile(outputFile, mergeBinary(readBinaryFile(baseFile), skeletonHashString(base), shards))) return 1;
+        } else {
+            auto readJson = [](const std::string& path) {
+                std::ifstream ifs(path);
+                if (!ifs) throw std::runtime_error("Cannot open input file: " + path);
+                Json json;
+                ifs >> json;
+                return json;
+            };
+            std::vector<Json> shards;
+            for (const auto& shardFile : shardFiles) shards.push_back(readJson(shardFile));
+            if (!writeTextFile(outputFile, dumpJson(mergeJson(readJson(baseFile), shards)))) return 1;
         }
-        
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error during conversion: " << e.what() << "\n";
-        return false;
+        std::cout << "Merged " << shardFiles.size() << " shards into " << outputFile << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during merge: " << e.what() << "\n";
+        return 1;
     }
 }
 
 void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " <input_file> <output_file> [options]\n\n";
+    std::cout << "Usage: " << programName << " <input_file> <output_file> [options]\n";
+    std::cout << "       " << programName << " --diff <file1> <file2> [<file1> <file2> ...] [diff options]\n";
+    std::cout << "       " << programName << " --diff-all <directory> <suffix1> <suffix2> [diff options]\n";
+    std::cout << "       " << programName << " --merge <base> <output> [<shard> ...]\n\n";
     std::cout << "Supported file formats:\n";
     std::cout << "  .json       Spine JSON format\n";
     std::cout << "  .skel       Spine binary (SKEL) format\n\n";
     std::cout << "Options:\n";
     std::cout << "  -v          Output version (must be complete: x.y.z format)\n";
     std::cout << "  --remove-curve  Strip animation curves instead of converting between formats\n";
+    std::cout << "  --animations <a,b,...>  Keep only these animations, dropping bones, slots and constraints no longer used\n";
+    std::cout << "              (.skel input: the other animations are skipped without being decoded)\n";
+    std::cout << "  --skins <x,y,...>  Keep only these skins (and the default skin), same clean-up\n";
+    std::cout << "  --index     Also write <output>.index.json with each animation's byte range, duration,\n";
+    std::cout << "              timeline counts and keyed bones and slots (.skel output)\n";
+    std::cout << "  --split     Write the skeleton without animations to <output> and each animation to\n";
+    std::cout << "              <stem>.<animation><ext>, tagged with the skeleton hash; --merge reassembles them\n";
+    std::cout << "              (shards default to every <stem>.*<ext> next to the base)\n";
+    std::cout << "  --group <name>=<a,b,...>  With --split, put these animations together in <stem>.<name><ext>\n";
+    std::cout << "  --scale <s>  Multiply bones, attachments, translate/deform keys and other lengths by <s>,\n";
+    std::cout << "              so runtimes can load the skeleton with scale 1\n";
+    std::cout << "  --bake-curves <fps>  Resample bezier segments into linear keys at <fps>\n";
+    std::cout << "              (combine with --reduce-keys to keep only the samples needed within a tolerance)\n";
+    std::cout << "  --reduce-keys <tol>  Remove keys whose removal keeps every curve within <tol>\n";
+    std::cout << "              (degrees/pixels; scale, mix and percent values in %; colors in 8-bit steps)\n";
+    std::cout << "  --max-influences <n>  Keep the <n> strongest bone weights per vertex and renormalize them\n";
+    std::cout << "  --optimize-deform  Trim zero offsets from deform frames and drop frames repeating their neighbours\n";
+    std::cout << "  --optimize-triangles  Reorder mesh triangles for vertex cache locality\n";
+    std::cout << "  --reorder-vertices  Also renumber mesh vertices by first use (implies --optimize-triangles)\n";
     std::cout << "  --help      Show this help message\n\n";
+    std::cout << "Diff options:\n";
+    std::cout << "  -t, --tolerance <r>     Relative tolerance for generic numbers (default 0.05)\n";
+    std::cout << "  --time-tolerance <s>    Absolute tolerance for key times in seconds (default 0.01)\n";
+    std::cout << "  --angle-tolerance <d>   Absolute tolerance for angles in degrees (default 0.05)\n";
+    std::cout << "  --color-tolerance <n>   Absolute tolerance per 8-bit color channel (default 1)\n";
+    std::cout << "  --curve-tolerance <r>   Relative tolerance for bezier control points (default 0.05)\n";
+    std::cout << "  -j, --jobs <n>          Number of file pairs compared in parallel (default: all cores)\n";
+    std::cout << "  -s, --summary-only      Only print one line per file pair\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " input.skel output.json\n";
     std::cout << "  " << programName << " input.json output.skel\n";
-    std::cout << "  " << programName << " input37.json output42.skel -v 4.2.11\n\n";
+    std::cout << "  " << programName << " input37.json output42.skel -v 4.2.11\n";
+    std::cout << "  " << programName << " --diff input.json input.json.skel.json\n";
+    std::cout << "  " << programName << " --diff-all ./data/42 .json .json.skel.json -s\n";
+    std::cout << "  " << programName << " input.skel out/hero.skel --split --group locomotion=walk,run\n";
+    std::cout << "  " << programName << " --merge out/hero.skel hero.skel\n\n";
     std::cout << "Supported Spine versions: 3.5.x, 3.6.x, 3.7.x, 3.8.x, 4.0.x, 4.1.x, 4.2.x\n";
     std::cout << "Note: Version must be specified in complete x.y.z format (e.g., 4.2.11, not 4.2)\n";
     std::cout << "Input version detection is automatic based on file content.\n";
     std::cout << "Output version defaults to input version unless specified with -v.\n";
 }
 
+DiffOptions parseDiffArguments(int argc, char* argv[]) {
+    DiffOptions options;
+    std::string mode = argv[1];
+    std::vector<std::string> files;
+    auto readValue = [&](int& i, const std::string& arg) -> std::optional<std::string> {
+        if (i + 1 < argc) return std::string(argv[++i]);
+        std::cerr << "Error: " << arg << " requires a value\n";
+        options.valid = false;
+        return std::nullopt;
+    };
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "-t" || arg == "--tolerance") {
+                if (auto value = readValue(i, arg)) options.tolerance.value = std::stof(*value);
+            } else if (arg == "--time-tolerance") {
+                if (auto value = readValue(i, arg)) options.tolerance.time = std::stof(*value);
+            } else if (arg == "--angle-tolerance") {
+                if (auto value = readValue(i, arg)) options.tolerance.angle = std::stof(*value);
+            } else if (arg == "--color-tolerance") {
+                if (auto value = readValue(i, arg)) options.tolerance.color = std::stoi(*value);
+            } else if (arg == "--curve-tolerance") {
+                if (auto value = readValue(i, arg)) options.tolerance.curve = std::stof(*value);
+            } else if (arg == "-j" || arg == "--jobs") {
+                if (auto value = readValue(i, arg)) options.jobs = std::stoi(*value);
+            } else if (arg == "-s" || arg == "--summary-only") {
+                options.summaryOnly = true;
+            } else if (arg.size() > 1 && arg[0] == '-' && arg[1] == '-') {
+                std::cerr << "Warning: Unknown option: " << arg << "\n";
+            } else {
+                files.push_back(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << arg << "\n";
+            options.valid = false;
+        }
+    }
+
+    if (mode == "--diff-all") {
+        if (files.size() != 3 || !std::filesystem::is_directory(files[0])) {
+            std::cerr << "Error: --diff-all requires <directory> <suffix1> <suffix2>\n";
+            options.valid = false;
+        } else {
+            options.pairs = findFilePairs(files[0], files[1], files[2]);
+        }
+    } else if (files.empty() || files.size() % 2 != 0) {
+        std::cerr << "Error: --diff requires file pairs\n";
+        options.valid = false;
+    } else {
+        for (size_t i = 0; i < files.size(); i += 2)
+            options.pairs.emplace_back(files[i], files[i + 1]);
+    }
+    return options;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        if (end > start) items.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
 ConversionOptions parseArguments(int argc, char* argv[]) {
     ConversionOptions options;
     
@@ -483,6 +430,78 @@ ConversionOptions parseArguments(int argc, char* argv[]) {
             options.help = true;
         } else if (arg == "--remove-curve") {
             options.removeCurve = true;
+        } else if (arg == "--bake-curves") {
+            float fps = 0.0f;
+            if (i + 1 < argc) {
+                try { fps = std::stof(argv[++i]); } catch (const std::exception&) {}
+            }
+            if (fps <= 0.0f) {
+                std::cerr << "Error: --bake-curves requires a positive frame rate\n";
+                options.help = true;
+            } else {
+                options.bakeCurvesFps = fps;
+            }
+        } else if (arg == "--scale") {
+            float scale = 0.0f;
+            if (i + 1 < argc) {
+                try { scale = std::stof(argv[++i]); } catch (const std::exception&) {}
+            }
+            if (scale <= 0.0f) {
+                std::cerr << "Error: --scale requires a positive factor\n";
+                options.help = true;
+            } else {
+                options.scale = scale;
+            }
+        } else if (arg == "--max-influences") {
+            int count = 0;
+            if (i + 1 < argc) {
+                try { count = std::stoi(argv[++i]); } catch (const std::exception&) {}
+            }
+            if (count < 1) {
+                std::cerr << "Error: --max-influences requires a positive count\n";
+                options.help = true;
+            } else {
+                options.maxInfluences = count;
+            }
+        } else if (arg == "--animations" || arg == "--skins") {
+            std::vector<std::string> names = i + 1 < argc ? splitList(argv[++i]) : std::vector<std::string>();
+            if (names.empty()) {
+                std::cerr << "Error: " << arg << " requires a comma-separated list of names\n";
+                options.help = true;
+            } else {
+                (arg == "--animations" ? options.animations : options.skins) = names;
+            }
+        } else if (arg == "--index") {
+            options.writeIndex = true;
+        } else if (arg == "--split") {
+            options.split = true;
+        } else if (arg == "--group") {
+            std::string value = i + 1 < argc ? argv[++i] : "";
+            size_t equals = value.find('=');
+            std::vector<std::string> names = equals == std::string::npos ? std::vector<std::string>() : splitList(value.substr(equals + 1));
+            if (equals == 0 || names.empty()) {
+                std::cerr << "Error: --group requires <name>=<a,b,...>\n";
+                options.help = true;
+            } else {
+                options.groups.push_back({value.substr(0, equals), names});
+            }
+        } else if (arg == "--optimize-deform") {
+            options.optimizeDeform = true;
+        } else if (arg == "--optimize-triangles") {
+            options.optimizeTriangles = true;
+        } else if (arg == "--reorder-vertices") {
+            options.reorderVertices = true;
+        } else if (arg == "--reduce-keys") {
+            float tolerance = -1.0f;
+            if (i + 1 < argc) {
+                try { tolerance = std::stof(argv[++i]); } catch (const std::exception&) {}
+            }
+            if (tolerance < 0.0f) {
+                std::cerr << "Error: --reduce-keys requires a non-negative tolerance\n";
+                options.help = true;
+            } else {
+                options.reduceKeysTolerance = tolerance;
+            }
         } else {
             std::cerr << "Warning: Unknown option: " << arg << "\n";
         }
@@ -492,6 +511,18 @@ ConversionOptions parseArguments(int argc, char* argv[]) {
 }
 
 int main(int argc, char* argv[]) {
+    if (argc > 1 && (std::string(argv[1]) == "--diff" || std::string(argv[1]) == "--diff-all")) {
+        DiffOptions diffOptions = parseDiffArguments(argc, argv);
+        if (!diffOptions.valid) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runDiff(diffOptions);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--merge") {
+        return runMerge(argc, argv);
+    }
+
     ConversionOptions options = parseArguments(argc, argv);
     
     if (options.help) {
@@ -509,33 +540,16 @@ int main(int argc, char* argv[]) {
     if ((options.inputFormat == FileFormat::Json || options.inputFormat == FileFormat::Skel) &&
         (options.outputFormat == FileFormat::Json || options.outputFormat == FileFormat::Skel)) {
         
-        // Detect input Spine version
-        SpineVersion inputVersion = detectSpineVersion(options.inputFile);
-        
-        if (inputVersion == SpineVersion::Invalid) {
-            std::cerr << "Error: Could not detect Spine version from input file\n";
-            return 1;
+        ConversionResult result;
+        try {
+            result = convertSkeleton(readBinaryFile(options.inputFile), options, std::cout, std::cerr);
         }
-        
-        // Use output version if specified, otherwise use input version
-        SpineVersion outputVersion = (options.outputVersion != SpineVersion::Invalid) ? options.outputVersion : inputVersion;
-        std::string outputVersionString = options.outputVersionString; // 使用用户指定的完整版本号
-        
-        std::cout << "Detected input Spine version: " << getVersionString(inputVersion) << "\n";
-        if (inputVersion != outputVersion) {
-            std::cout << "Converting to output Spine version: " << getVersionString(outputVersion);
-            if (!outputVersionString.empty()) {
-                std::cout << " (" << outputVersionString << ")";
-            }
-            std::cout << "\n";
-        }
-        if (options.removeCurve) {
-            std::cout << "Option --remove-curve enabled: curves will be stripped instead of converted when crossing 3.x/4.x.\n";
+        catch (const std::exception& e) {
+            std::cerr << "Error during conversion: " << e.what() << "\n";
+            std::cerr << "Conversion failed!\n";
+            return 1;
         }
-        std::cout << "Converting from " << (options.inputFormat == FileFormat::Json ? "JSON" : "SKEL") 
-                  << " to " << (options.outputFormat == FileFormat::Json ? "JSON" : "SKEL") << "...\n";
-        
-        if (convertFile(options.inputFile, options.outputFile, options.inputFormat, options.outputFormat, inputVersion, outputVersion, outputVersionString, options.removeCurve)) {
+        if (writeOutputs(options, result)) {
             std::cout << "Conversion completed successfully!\n";
             std::cout << "Output file: " << options.outputFile << "\n";
             return 0;
@@ -0,0 +1,148 @@
+#include "spineconv.h"
+#include "SkeletonData.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+struct spineconv_result {
+    bool ok = false;
+    std::string diagnostics;
+    ConversionResult conversion;
+};
+
+namespace {
+
+std::vector<std::string> nameList(const char* const* names, size_t count) {
+    std::vector<std::string> list;
+    for (size_t i = 0; names && i < count; i++) {
+        if (names[i]) list.push_back(names[i]);
+    }
+    return list;
+}
+
+FileFormat fileFormat(int format) {
+    switch (format) {
+        case SPINECONV_FORMAT_AUTO: return FileFormat::Unknown;
+        case SPINECONV_FORMAT_JSON: return FileFormat::Json;
+        case SPINECONV_FORMAT_SKEL: return FileFormat::Skel;
+        default: throw std::runtime_error("Invalid format " + std::to_string(format));
+    }
+}
+
+// "name=a,b,..." as the command line's --group takes it.
+AnimationGroup animationGroup(const std::string& value) {
+    AnimationGroup group;
+    size_t equals = value.find('=');
+    if (equals != std::string::npos) {
+        group.name = value.substr(0, equals);
+        for (size_t start = equals + 1; start <= value.size();) {
+            size_t end = std::min(value.find(',', start), value.size());
+            if (end > start) group.animations.push_back(value.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+    if (group.name.empty() || group.animations.empty()) throw std::runtime_error("Invalid group: " + value);
+    return group;
+}
+
+// The caller's options over the defaults, as far as the caller's struct reaches.
+ConversionSettings conversionSettings(const spineconv_options* options) {
+    spineconv_options values;
+    spineconv_options_init(&values);
+    if (options) std::memcpy(&values, options, std::min(options->size, sizeof(values)));
+    values.size = sizeof(values);
+
+    ConversionSettings settings;
+    settings.inputFormat = fileFormat(values.input_format);
+    settings.outputFormat = fileFormat(values.output_format);
+    if (values.output_version) {
+        settings.outputVersionString = values.output_version;
+        settings.outputVersion = parseVersionString(settings.outputVersionString);
+        if (settings.outputVersion == SpineVersion::Invalid) throw std::runtime_error("Invalid output version: " + settings.outputVersionString);
+    }
+    settings.removeCurve = values.remove_curve != 0;
+    if (values.scale > 0.0f) settings.scale = values.scale;
+    if (values.bake_curves_fps > 0.0f) settings.bakeCurvesFps = values.bake_curves_fps;
+    if (values.reduce_keys_tolerance >= 0.0f) settings.reduceKeysTolerance = values.reduce_keys_tolerance;
+    if (values.max_influences > 0) settings.maxInfluences = values.max_influences;
+    settings.optimizeDeform = values.optimize_deform != 0;
+    settings.optimizeTriangles = values.optimize_triangles != 0;
+    settings.reorderVertices = values.reorder_vertices != 0;
+    settings.animations = nameList(values.animations, values.animation_count);
+    settings.skins = nameList(values.skins, values.skin_count);
+    settings.writeIndex = values.write_index != 0;
+    settings.split = values.split != 0;
+    for (const auto& group : nameList(values.groups, values.group_count)) settings.groups.push_back(animationGroup(group));
+    return settings;
+}
+
+}
+
+int spineconv_abi_version(void) {
+    return SPINECONV_ABI_VERSION;
+}
+
+void spineconv_options_init(spineconv_options* options) {
+    if (!options) return;
+    std::memset(options, 0, sizeof(*options));
+    options->size = sizeof(*options);
+    options->reduce_keys_tolerance = -1.0f;
+}
+
+spineconv_result* spineconv_convert(const void* data, size_t size, const spineconv_options* options) {
+    spineconv_result* result = new (std::nothrow) spineconv_result;
+    if (!result) return nullptr;
+    std::ostringstream diagnostics;
+    try {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        result->conversion = convertSkeleton(Binary(bytes, bytes + (bytes ? size : 0)), conversionSettings(options), diagnostics, diagnostics);
+        result->ok = true;
+    } catch (const std::exception& e) {
+        diagnostics << "Error during conversion: " << e.what() << "\n";
+    } catch (...) {
+        // Nothing may propagate into C callers.
+        diagnostics << "Error during conversion: unknown exception\n";
+    }
+    try {
+        result->diagnostics = diagnostics.str();
+    } catch (...) {
+    }
+    return result;
+}
+
+void spineconv_result_free(spineconv_result* result) {
+    delete result;
+}
+
+int spineconv_result_ok(const spineconv_result* result) {
+    return result && result->ok;
+}
+
+const char* spineconv_result_diagnostics(const spineconv_result* result) {
+    return result ? result->diagnostics.c_str() : "";
+}
+
+const unsigned char* spineconv_result_data(const spineconv_result* result, size_t* size) {
+    if (size) *size = result ? result->conversion.output.size() : 0;
+    return result ? result->conversion.output.data() : nullptr;
+}
+
+size_t spineconv_result_shard_count(const spineconv_result* result) {
+    return result ? result->conversion.shards.size() : 0;
+}
+
+const char* spineconv_result_shard_name(const spineconv_result* result, size_t index) {
+    if (!result || index >= result->conversion.shards.size()) return nullptr;
+    return result->conversion.shards[index].first.c_str();
+}
+
+const unsigned char* spineconv_result_shard_data(const spineconv_result* result, size_t index, size_t* size) {
+    bool valid = result && index < result->conversion.shards.size();
+    if (size) *size = valid ? result->conversion.shards[index].second.size() : 0;
+    return valid ? result->conversion.shards[index].second.data() : nullptr;
+}
+
+const char* spineconv_result_index(const spineconv_result* result) {
+    return result && !result->conversion.index.empty() ? result->conversion.index.c_str() : nullptr;
+}
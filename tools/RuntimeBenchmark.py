@@ -0,0 +1,107 @@
+import argparse
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+RUNTIMES = ("37", "38", "40", "41", "42")
+OK_PATTERN = re.compile(r"^\[OK\] (.+?)((?: \w+=\S+)+)$")
+FAIL_PATTERN = re.compile(r"^\[FAIL\] (.+?): (.*)$")
+# Metric compared between original and converted files, and extra metric shown alongside it, per mode.
+MODES = {
+	"load": ("load_ms_median", "retained_kb"),
+	"animate": ("ns_per_frame_median", "frames"),
+}
+
+
+def locate_benchmark(build_dir: Path, runtime: str) -> Path:
+	name = f"SpineRuntimeBenchmark{runtime}"
+	for candidate in [build_dir / name, build_dir / f"{name}.exe", *build_dir.rglob(f"{name}.exe"), *build_dir.rglob(name)]:
+		if candidate.is_file():
+			return candidate
+	raise FileNotFoundError(f"Could not locate {name} under {build_dir}")
+
+
+def find_file_pairs(root: Path, original_suffix: str, converted_suffix: str) -> list[tuple[Path, Path]]:
+	pairs = []
+	for original in sorted(root.rglob(f"*{original_suffix}")):
+		if not original.name.endswith(original_suffix) or original.name.endswith(converted_suffix):
+			continue
+		converted = original.with_name(original.name[: -len(original_suffix)] + converted_suffix)
+		if converted.is_file():
+			pairs.append((original, converted))
+	return pairs
+
+
+def run_benchmark(executable: Path, mode: str, options: list[str], files: list[Path]) -> dict[str, tuple[dict[str, float], str]]:
+	command = [str(executable), mode, *options, *[str(path) for path in files]]
+	completed = subprocess.run(command, capture_output=True, text=True)
+	results = {}
+	for line in completed.stdout.splitlines():
+		match = OK_PATTERN.match(line)
+		if match:
+			metrics = dict(item.split("=", 1) for item in match.group(2).split())
+			results[match.group(1)] = ({key: float(value) for key, value in metrics.items()}, "")
+			continue
+		match = FAIL_PATTERN.match(line)
+		if match:
+			results[match.group(1)] = ({}, match.group(2))
+	for path in files:
+		results.setdefault(str(path), ({}, completed.stderr.strip() or f"exit code {completed.returncode}"))
+	return results
+
+
+def main() -> int:
+	parser = argparse.ArgumentParser(description="Compare runtime load time or animation sampling cost of original and converted skeletons with the vendored spine-cpp runtimes.")
+	parser.add_argument("directory", type=Path, help="Directory searched recursively for file pairs")
+	parser.add_argument("original_suffix", help="Suffix of the original files, e.g. .skel")
+	parser.add_argument("converted_suffix", help="Suffix of the converted files, e.g. .skel.38.json")
+	parser.add_argument("--build-dir", type=Path, default=Path("build"), help="CMake build directory containing SpineRuntimeBenchmarkXX")
+	parser.add_argument("--original-runtime", choices=RUNTIMES, required=True, help="Runtime used for the original files, e.g. 42")
+	parser.add_argument("--converted-runtime", choices=RUNTIMES, help="Runtime used for the converted files (defaults to --original-runtime)")
+	parser.add_argument("--mode", choices=MODES.keys(), default="load", help="load: time SkeletonBinary/SkeletonJson; animate: time AnimationState::apply + updateWorldTransform")
+	parser.add_argument("--iterations", "-n", type=int, default=20, help="Loads per file in load mode (default 20)")
+	parser.add_argument("--fps", type=float, default=60, help="Sampling rate in animate mode (default 60)")
+	parser.add_argument("--loops", type=int, default=10, help="Plays per animation in animate mode (default 10)")
+	parser.add_argument("--max-slowdown", type=float, default=None, help="Also fail when the converted median exceeds the original by this ratio, e.g. 1.1")
+	args = parser.parse_args()
+
+	if args.mode == "load":
+		options = ["--iterations", str(args.iterations)]
+	else:
+		options = ["--fps", str(args.fps), "--loops", str(args.loops)]
+	metric, extra = MODES[args.mode]
+
+	pairs = find_file_pairs(args.directory, args.original_suffix, args.converted_suffix)
+	if not pairs:
+		print(f"No file pairs found under {args.directory}")
+		return 1
+
+	original_results = run_benchmark(locate_benchmark(args.build_dir, args.original_runtime), args.mode, options, [original for original, _ in pairs])
+	converted_results = run_benchmark(locate_benchmark(args.build_dir, args.converted_runtime or args.original_runtime), args.mode, options, [converted for _, converted in pairs])
+
+	failures = 0
+	for original, converted in pairs:
+		original_metrics, original_error = original_results[str(original)]
+		converted_metrics, converted_error = converted_results[str(converted)]
+		if converted_error:
+			failures += 1
+			print(f"[FAIL] {converted}: {converted_error}")
+			continue
+		if original_error:
+			print(f"[SKIP] {original}: {original_error}")
+			continue
+		before, after = original_metrics[metric], converted_metrics[metric]
+		ratio = after / before if before > 0 else 1.0
+		status = "OK"
+		if args.max_slowdown is not None and ratio > args.max_slowdown:
+			failures += 1
+			status = "SLOW"
+		print(f"[{status}] {converted} {metric}={before:.3f}->{after:.3f} ({ratio:.2f}x) {extra}={original_metrics[extra]:.0f}->{converted_metrics[extra]:.0f}")
+
+	print(f"\n{len(pairs)} pairs, {failures} failures")
+	return 1 if failures else 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
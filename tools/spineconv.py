@@ -0,0 +1,124 @@
+import ctypes
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+
+FORMAT_AUTO = 0
+FORMAT_JSON = 1
+FORMAT_SKEL = 2
+ABI_VERSION = 1
+
+
+class _Options(ctypes.Structure):
+	_fields_ = [
+		("size", ctypes.c_size_t),
+		("input_format", ctypes.c_int),
+		("output_format", ctypes.c_int),
+		("output_version", ctypes.c_char_p),
+		("remove_curve", ctypes.c_int),
+		("scale", ctypes.c_float),
+		("bake_curves_fps", ctypes.c_float),
+		("reduce_keys_tolerance", ctypes.c_float),
+		("max_influences", ctypes.c_int),
+		("optimize_deform", ctypes.c_int),
+		("optimize_triangles", ctypes.c_int),
+		("reorder_vertices", ctypes.c_int),
+		("animations", ctypes.POINTER(ctypes.c_char_p)),
+		("animation_count", ctypes.c_size_t),
+		("skins", ctypes.POINTER(ctypes.c_char_p)),
+		("skin_count", ctypes.c_size_t),
+		("write_index", ctypes.c_int),
+		("split", ctypes.c_int),
+		("groups", ctypes.POINTER(ctypes.c_char_p)),
+		("group_count", ctypes.c_size_t),
+	]
+
+
+@dataclass
+class ConversionResult:
+	ok: bool
+	diagnostics: str
+	data: bytes = b""
+	shards: list[tuple[str, bytes]] = field(default_factory=list)
+	index: str | None = None
+
+
+def _library_name() -> str:
+	if sys.platform == "win32":
+		return "spineconv.dll"
+	if sys.platform == "darwin":
+		return "libspineconv.dylib"
+	return "libspineconv.so"
+
+
+def locate_library(name: str = _library_name()) -> Path:
+	script_dir = Path(__file__).resolve().parent
+	for search_dir in (script_dir, script_dir.parent):
+		for candidate in search_dir.rglob(name):
+			if candidate.is_file():
+				return candidate
+	raise FileNotFoundError(f"Could not locate {name} under {script_dir.parent}. Build the spineconv_shared target first.")
+
+
+class SpineConv:
+	"""The converter loaded in-process from the shared spineconv library."""
+
+	def __init__(self, path: Path | None = None):
+		lib = ctypes.CDLL(str(path or locate_library()))
+		lib.spineconv_abi_version.restype = ctypes.c_int
+		lib.spineconv_options_init.argtypes = [ctypes.POINTER(_Options)]
+		lib.spineconv_convert.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.POINTER(_Options)]
+		lib.spineconv_convert.restype = ctypes.c_void_p
+		lib.spineconv_result_free.argtypes = [ctypes.c_void_p]
+		lib.spineconv_result_ok.argtypes = [ctypes.c_void_p]
+		lib.spineconv_result_diagnostics.argtypes = [ctypes.c_void_p]
+		lib.spineconv_result_diagnostics.restype = ctypes.c_char_p
+		lib.spineconv_result_data.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_size_t)]
+		lib.spineconv_result_data.restype = ctypes.POINTER(ctypes.c_ubyte)
+		lib.spineconv_result_shard_count.argtypes = [ctypes.c_void_p]
+		lib.spineconv_result_shard_count.restype = ctypes.c_size_t
+		lib.spineconv_result_shard_name.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+		lib.spineconv_result_shard_name.restype = ctypes.c_char_p
+		lib.spineconv_result_shard_data.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t)]
+		lib.spineconv_result_shard_data.restype = ctypes.POINTER(ctypes.c_ubyte)
+		lib.spineconv_result_index.argtypes = [ctypes.c_void_p]
+		lib.spineconv_result_index.restype = ctypes.c_char_p
+		if lib.spineconv_abi_version() != ABI_VERSION:
+			raise RuntimeError(f"spineconv ABI version {lib.spineconv_abi_version()}, expected {ABI_VERSION}")
+		self._lib = lib
+
+	def convert(self, data: bytes, output_format: int = FORMAT_AUTO, output_version: str | None = None,
+				animations: list[str] = (), skins: list[str] = (), groups: list[str] = (), **flags) -> ConversionResult:
+		"""Converts a .json or .skel skeleton. `flags` are the other option fields, e.g. remove_curve=True, scale=0.5."""
+		options = _Options()
+		self._lib.spineconv_options_init(ctypes.byref(options))
+		options.output_format = output_format
+		options.output_version = output_version.encode() if output_version else None
+		keep = []
+		for name, values in (("animations", animations), ("skins", skins), ("groups", groups)):
+			array = (ctypes.c_char_p * len(values))(*[value.encode() for value in values])
+			keep.append(array)
+			setattr(options, name, array)
+			setattr(options, name[:-1] + "_count", len(values))
+		for name, value in flags.items():
+			setattr(options, name, value)
+
+		result = self._lib.spineconv_convert(data, len(data), ctypes.byref(options))
+		if not result:
+			raise MemoryError("spineconv_convert")
+		try:
+			size = ctypes.c_size_t()
+			output = self._lib.spineconv_result_data(result, ctypes.byref(size))
+			converted = ConversionResult(
+				ok=bool(self._lib.spineconv_result_ok(result)),
+				diagnostics=self._lib.spineconv_result_diagnostics(result).decode(errors="replace"),
+				data=ctypes.string_at(output, size.value) if size.value else b"",
+			)
+			for i in range(self._lib.spineconv_result_shard_count(result)):
+				shard = self._lib.spineconv_result_shard_data(result, i, ctypes.byref(size))
+				converted.shards.append((self._lib.spineconv_result_shard_name(result, i).decode(), ctypes.string_at(shard, size.value)))
+			index = self._lib.spineconv_result_index(result)
+			converted.index = index.decode() if index is not None else None
+			return converted
+		finally:
+			self._lib.spineconv_result_free(result)